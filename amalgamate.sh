@@ -0,0 +1,46 @@
+#!/bin/sh
+#
+# Bundles the mark4 bot into a single C file, the referee only takes one.
+#
+#     ./amalgamate.sh > bot.c
+#     cc -O2 -o bot bot.c -lm
+#
+# Local headers are inlined where they are first included and dropped after
+# that, system headers are left as they are. The bundle is built with
+# SINGLE_THREADED and MARK4_ONLY, see strategies.c.
+set -e
+cd "$(dirname "$0")"
+
+SOURCES="main.c engine.c strategies.c movement.c symmetry.c radar.c danger.c intmath.c surfacing.c endgame.c foe.c lure.c rhea.c eval.c record.c pool.c trace.c fishsim.c tt.c search.c mark4.c"
+
+echo "/* Generated by amalgamate.sh from $(git rev-parse --short HEAD 2>/dev/null || echo "an unknown revision"), do not edit. */"
+echo "#define SINGLE_THREADED"
+echo "#define MARK4_ONLY"
+
+awk '
+function inline_file(file,    line, header, number) {
+	printf("#line 1 \"%s\"\n", file)
+	number = 0
+	while ((getline line < file) > 0) {
+		number++
+		if (line ~ /^#include "[^"]+"/) {
+			header = line
+			sub(/^#include "/, "", header)
+			sub(/".*/, "", header)
+			if (!(header in inlined)) {
+				inlined[header] = 1
+				inline_file(header)
+				printf("#line %d \"%s\"\n", number + 1, file)
+			}
+			continue
+		}
+		print line
+	}
+	close(file)
+}
+
+BEGIN {
+	for (i = 1; i < ARGC; i++) { inline_file(ARGV[i]) }
+	exit
+}
+' $SOURCES
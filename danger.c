@@ -0,0 +1,115 @@
+#include "danger.h"
+#include "intmath.h"
+#include "radar.h"
+
+/* NOTE(benjamin): Half the cell diagonal, a cell is flagged when any of its points could be hit. */
+#define CELL_MARGIN ((DANGER_CELL_SIZE * 3) / 4)
+#define REACH (MONSTER_COLLISION_DISTANCE + CELL_MARGIN)
+
+/* Widest sideways distance from a box still within reach, by the distance above or below it. */
+static int reach_half_width[REACH + 1];
+static bool templates_ready;
+
+void danger_init(void) {
+	if (templates_ready) { return; }
+
+	for (int dy = 0; dy <= REACH; dy++) {
+		reach_half_width[dy] = isqrt(((long)REACH * REACH) - ((long)dy * dy));
+	}
+	templates_ready = true;
+}
+
+static struct box point_box(int x, int y) {
+	return (struct box){ x, x, y, y };
+}
+
+static struct box widen(struct box box, int by) {
+	return (struct box){ box.left_x - by, box.right_x + by, box.top_y - by, box.bottom_y + by };
+}
+
+static struct box merge(struct box a, struct box b) {
+	return (struct box){ MIN(a.left_x, b.left_x), MAX(a.right_x, b.right_x), MIN(a.top_y, b.top_y), MAX(a.bottom_y, b.bottom_y) };
+}
+
+/* Rounds toward minus infinity, the box edges reach past the map. */
+static int floor_div(int a, int b) {
+	return (0 <= a) ? a / b : -((-a + b - 1) / b);
+}
+
+/*
+ * A box within reach flags whole runs of cells: every row gets the span of
+ * the box widened by how far a cell center of that row may be from the box
+ * sideways, which only depends on how far the row is above or below it.
+ */
+static void flag_box(struct danger_grid *grid, struct box box, int turn) {
+	int first_y = MAX(0, floor_div(box.top_y - REACH - (DANGER_CELL_SIZE / 2) + DANGER_CELL_SIZE - 1, DANGER_CELL_SIZE));
+	int last_y = MIN(DANGER_CELLS - 1, floor_div(box.bottom_y + REACH - (DANGER_CELL_SIZE / 2), DANGER_CELL_SIZE));
+
+	for (int cy = first_y; cy <= last_y; cy++) {
+		int y = (cy * DANGER_CELL_SIZE) + (DANGER_CELL_SIZE / 2);
+		int dy = (y < box.top_y) ? box.top_y - y : (box.bottom_y < y) ? y - box.bottom_y : 0;
+		int half_width = reach_half_width[dy];
+
+		int first_x = MAX(0, floor_div(box.left_x - half_width - (DANGER_CELL_SIZE / 2) + DANGER_CELL_SIZE - 1, DANGER_CELL_SIZE));
+		int last_x = MIN(DANGER_CELLS - 1, floor_div(box.right_x + half_width - (DANGER_CELL_SIZE / 2), DANGER_CELL_SIZE));
+		for (int cx = first_x; cx <= last_x; cx++) {
+			grid->cells[cy][cx] |= 1 << (turn - 1);
+		}
+	}
+}
+
+static struct box clamped_point_box(int x, int y) {
+	return point_box(MAX(0, MIN(MAX_X - 1, x)), MAX(0, MIN(MAX_Y - 1, y)));
+}
+
+/*
+ * Guessed position at the end of turn t, 0 being now, kept within the map
+ * like the monsters of the search. The speed of a visible monster holds for
+ * the coming move, it may only turn after that. A hidden one is tested on
+ * its stale speed for the coming move and stands still in the lookahead.
+ */
+static struct box guess_box(const struct fish *monster, int t) {
+	if (!t) { return point_box(monster->x, monster->y); }
+
+	if (monster->visible) {
+		struct box box = clamped_point_box(monster->x + (monster->vx * t), monster->y + (monster->vy * t));
+		return widen(box, (t - 1) * MONSTER_CHASE_SPEED);
+	}
+
+	return merge(point_box(monster->x, monster->y), clamped_point_box(monster->x + monster->vx, monster->y + monster->vy));
+}
+
+/*
+ * Swept by the monster during the move of turn t. The exact tests move it
+ * from the guess at t - 1 by its whole speed, a map edge only holds it back
+ * at the start of the next move.
+ */
+static struct box move_box(const struct fish *monster, int t) {
+	struct box from = guess_box(monster, t - 1);
+	if (!monster->visible) { return merge(from, guess_box(monster, t)); }
+
+	struct box to = { from.left_x + monster->vx, from.right_x + monster->vx, from.top_y + monster->vy, from.bottom_y + monster->vy };
+	return merge(from, widen(to, (t == 1) ? 0 : MONSTER_CHASE_SPEED));
+}
+
+void danger_build(struct danger_grid *grid, int turns) {
+	assert(turns <= DANGER_TURNS, "danger grid only has %d turns\n", DANGER_TURNS);
+	assert(templates_ready, "danger_build() before danger_init()\n");
+	memset(grid, 0, sizeof(*grid));
+
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *monster = &state.entities[id].fish;
+		if (monster->type != -1) { continue; }
+
+		struct box radar = radar_box(monster);
+
+		for (int t = 1; t <= turns; t++) {
+			flag_box(grid, move_box(monster, t), t);
+
+			/* NOTE(benjamin): The guess of a visible monster already is its radar box. */
+			struct box reach = widen(radar, t * MONSTER_CHASE_SPEED);
+			if (monster->visible || DANGER_UNCERTAINTY_MAX < MAX(reach.right_x - reach.left_x, reach.bottom_y - reach.top_y)) { continue; }
+			flag_box(grid, reach, t);
+		}
+	}
+}
@@ -0,0 +1,41 @@
+/*
+ * Coarse map of where monsters may be during the next few turns.
+ *
+ * Built once per turn for every monster from two regions: the guessed
+ * position the exact collision tests use, moving at the monster's speed when
+ * it is in sight, and the radar box spread by the chasing speed for every
+ * turn the monster could have changed course. A cell is flagged for turn t
+ * when a monster may come within collision distance of it during the move of
+ * turn t (t = 1 is the move being chosen).
+ *
+ * The guessed positions are always drawn so a cell left clear never hides a
+ * collision the exact tests would find. Radar boxes too wide to tell anything
+ * apart are left out.
+ */
+#ifndef DANGER_H
+#define DANGER_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+#define DANGER_CELL_SIZE (100)
+#define DANGER_CELLS (MAX_X / DANGER_CELL_SIZE)
+#define DANGER_TURNS (8)
+#define DANGER_UNCERTAINTY_MAX (3000) /* widest radar box still drawn */
+
+struct danger_grid {
+	uint8_t cells[DANGER_CELLS][DANGER_CELLS]; /* [y][x], bit t-1 for turn t */
+};
+
+/* Precomputes the cell spans drawn around every box, once, before any danger_build(). */
+void danger_init(void);
+void danger_build(struct danger_grid *grid, int turns);
+
+static inline bool danger_at(const struct danger_grid *grid, int x, int y, int turn) {
+	x = MAX(0, MIN(DANGER_CELLS - 1, x / DANGER_CELL_SIZE));
+	y = MAX(0, MIN(DANGER_CELLS - 1, y / DANGER_CELL_SIZE));
+	return (grid->cells[y][x] >> (turn - 1)) & 1;
+}
+
+#endif
@@ -0,0 +1,228 @@
+#include "endgame.h"
+
+#define MEMO_SIZE (1 << ENDGAME_MEMO_BITS)
+#define EVENTS_MAX (TOTAL_DRONE_COUNT)
+#define COMBO_TYPE_SHIFT (FISH_COLOR_COUNT)
+
+struct save_event {
+	int turn;
+	int player; /* 0 for me, 1 for the foe */
+	uint32_t scans;
+};
+
+struct memo_entry {
+	uint64_t key; /* 0 when empty */
+	int delta;
+};
+
+static struct memo_entry memo[MEMO_SIZE];
+
+/* NOTE(benjamin): Same for both players of a game, filled again by every endgame_solve(). */
+static uint32_t color_masks[FISH_COLOR_COUNT];
+static uint32_t type_masks[FISH_TYPE_COUNT];
+
+void endgame_reset(void) {
+	memset(memo, 0, sizeof(memo));
+}
+
+static void fill_combo_masks(void) {
+	memset(color_masks, 0, sizeof(color_masks));
+	memset(type_masks, 0, sizeof(type_masks));
+
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *fish = &state.entities[id].fish;
+		if (fish->type == -1) { continue; }
+		color_masks[fish->color] |= 1u << FISH_INDEX(id);
+		type_masks[fish->type] |= 1u << FISH_INDEX(id);
+	}
+}
+
+static uint32_t combos_of(uint32_t saved) {
+	uint32_t combos = 0;
+
+	for (int color = 0; color < FISH_COLOR_COUNT; color++) {
+		if ((saved & color_masks[color]) == color_masks[color]) { combos |= 1u << color; }
+	}
+	for (int type = 0; type < FISH_TYPE_COUNT; type++) {
+		if ((saved & type_masks[type]) == type_masks[type]) { combos |= 1u << (COMBO_TYPE_SHIFT + type); }
+	}
+
+	return combos;
+}
+
+/* Score difference the saves earn, events sorted by turn. Same rules as save_scans() in the referee. */
+static int score_timeline(uint32_t my_saved, uint32_t foe_saved, const struct save_event *events, int count) {
+	uint32_t saved[PLAYER_COUNT] = { my_saved, foe_saved };
+	uint32_t combos[PLAYER_COUNT] = { combos_of(my_saved), combos_of(foe_saved) };
+	int gained[PLAYER_COUNT] = {};
+
+	for (int i = 0; i < count;) {
+		uint32_t saving[PLAYER_COUNT] = {};
+		int end = i;
+		for (; end < count && events[end].turn == events[i].turn; end++) {
+			saving[events[end].player] |= events[end].scans;
+		}
+		i = end;
+
+		uint32_t saved_before[PLAYER_COUNT] = { saved[0], saved[1] };
+		uint32_t combos_before[PLAYER_COUNT] = { combos[0], combos[1] };
+
+		for (int p = 0; p < PLAYER_COUNT; p++) {
+			uint32_t new_scans = saving[p] & ~saved[p];
+
+			for (int f = 0; f < FISH_COUNT; f++) {
+				if (!(new_scans & (1u << f))) { continue; }
+				int points = state.entities[TOTAL_DRONE_COUNT + f].fish.type + 1;
+				gained[p] += (saved_before[!p] & (1u << f)) ? points : 2 * points;
+			}
+			saved[p] |= new_scans;
+
+			uint32_t completed = combos_of(saved[p]) & ~combos[p];
+			for (int bit = 0; bit < COMBO_TYPE_SHIFT + FISH_TYPE_COUNT; bit++) {
+				if (!(completed & (1u << bit))) { continue; }
+				bool first = !(combos_before[!p] & (1u << bit));
+				if (bit < COMBO_TYPE_SHIFT) {
+					gained[p] += first ? 6 : 3;
+				} else {
+					gained[p] += first ? 8 : 4;
+				}
+			}
+			combos[p] |= completed;
+		}
+	}
+
+	return gained[0] - gained[1];
+}
+
+static uint64_t mix(uint64_t hash, uint64_t value) {
+	hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	return hash * 0xff51afd7ed558ccdULL;
+}
+
+static int timeline_delta(struct endgame_plan *plan, uint32_t my_saved, uint32_t foe_saved, struct save_event *events, int count) {
+	for (int i = 1; i < count; i++) {
+		struct save_event event = events[i];
+		int j = i;
+		for (; 0 < j && event.turn < events[j - 1].turn; j--) {
+			events[j] = events[j - 1];
+		}
+		events[j] = event;
+	}
+
+	/* NOTE(benjamin): Turns only matter through their order, the key carries the rank of each save instead. */
+	uint64_t key = mix(my_saved, foe_saved);
+	for (int i = 0, rank = 0; i < count; i++) {
+		if (i && events[i - 1].turn != events[i].turn) { rank += 1; }
+		key = mix(key, ((uint64_t)rank << 40) | ((uint64_t)events[i].player << 32) | events[i].scans);
+	}
+	key = key ? key : 1;
+
+	struct memo_entry *entry = &memo[key & (MEMO_SIZE - 1)];
+	plan->scored += 1;
+	if (entry->key == key) {
+		plan->memo_hits += 1;
+		return entry->delta;
+	}
+
+	entry->key = key;
+	entry->delta = score_timeline(my_saved, foe_saved, events, count);
+	return entry->delta;
+}
+
+static uint32_t scan_mask(const int *scans, int count) {
+	uint32_t mask = 0;
+	for (int i = 0; i < count; i++) {
+		mask |= 1u << FISH_INDEX(scans[i]);
+	}
+	return mask;
+}
+
+static int drone_routes(const struct drone *drone, struct endgame_route routes[ENDGAME_ROUTES_MAX]) {
+	if (drone->emergency) {
+		routes[0] = (struct endgame_route){ ENDGAME_HOLD, -1, GAME_TURN_MAX, 0 };
+		return 1;
+	}
+
+	struct surfacing_plan surfacing;
+	surfacing_plan_drone(drone, &surfacing);
+
+	int turns_left = GAME_TURN_MAX - state.turn;
+	int count = 0;
+
+	/* NOTE(benjamin): Rising comes first so it wins the ties, banked points cannot be lost to a monster. */
+	if (surfacing.pending) {
+		int save_turn = MIN(GAME_TURN_MAX, state.turn + surfacing.surface_turns);
+		routes[count++] = (struct endgame_route){ ENDGAME_RISE, -1, save_turn, surfacing.pending };
+	}
+
+	int turns = 0;
+	int x = drone->x;
+	int y = drone->y;
+	uint32_t fetched = surfacing.pending;
+
+	for (int k = 0; k < surfacing.chain_count; k++) {
+		const struct fish *fish = &state.entities[surfacing.chain[k]].fish;
+		turns += surfacing_reach_turns(x, y, fish);
+		if (turns_left < turns) { break; }
+
+		fetched |= 1u << FISH_INDEX(surfacing.chain[k]);
+		x = fish->x;
+		y = fish->y;
+
+		int save_turn = state.turn + turns + surfacing_turns(y);
+		if (save_turn < GAME_TURN_MAX) {
+			routes[count++] = (struct endgame_route){ ENDGAME_FETCH, surfacing.chain[0], save_turn, fetched };
+		}
+	}
+
+	/* NOTE(benjamin): A holding drone plays as usual and follows no chain, only what it carries is sure to be saved. */
+	routes[count++] = (struct endgame_route){ ENDGAME_HOLD, -1, GAME_TURN_MAX, surfacing.pending };
+	return count;
+}
+
+void endgame_solve(struct endgame_plan *plan) {
+	fill_combo_masks();
+	plan->scored = 0;
+	plan->memo_hits = 0;
+
+	uint32_t my_saved = scan_mask(state.my.scans, state.my.scan_count);
+	uint32_t foe_saved = scan_mask(state.foe.scans, state.foe.scan_count);
+
+	struct save_event foe_events[PLAYER_DRONE_COUNT];
+	int foe_event_count = 0;
+	for (int i = 0; i < state.foe.drone_count; i++) {
+		struct drone *drone = &state.entities[state.foe.drones[i]].drone;
+		uint32_t pending = scan_mask(drone->scans, drone->scan_count) & ~foe_saved;
+		if (drone->emergency || !pending) { continue; }
+
+		int save_turn = surfacing_rising(state.foe.drones[i]) ? MIN(GAME_TURN_MAX, state.turn + surfacing_turns(drone->y)) : GAME_TURN_MAX;
+		foe_events[foe_event_count++] = (struct save_event){ save_turn, 1, pending };
+	}
+
+	struct endgame_route routes[PLAYER_DRONE_COUNT][ENDGAME_ROUTES_MAX];
+	int route_counts[PLAYER_DRONE_COUNT];
+	for (int i = 0; i < PLAYER_DRONE_COUNT; i++) {
+		route_counts[i] = drone_routes(&state.entities[state.my.drones[i]].drone, routes[i]);
+	}
+
+	plan->delta = INT32_MIN;
+	for (int a = 0; a < route_counts[0]; a++) {
+		for (int b = 0; b < route_counts[1]; b++) {
+			struct save_event events[EVENTS_MAX];
+			int count = 0;
+
+			events[count++] = (struct save_event){ routes[0][a].save_turn, 0, routes[0][a].saving };
+			events[count++] = (struct save_event){ routes[1][b].save_turn, 0, routes[1][b].saving };
+			for (int i = 0; i < foe_event_count; i++) {
+				events[count++] = foe_events[i];
+			}
+
+			int delta = timeline_delta(plan, my_saved, foe_saved, events, count);
+			if (plan->delta < delta) {
+				plan->delta = delta;
+				plan->routes[0] = routes[0][a];
+				plan->routes[1] = routes[1][b];
+			}
+		}
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ * Endgame solver for the last turns of the match.
+ *
+ * Once few enough turns are left, every pair of routes for my drones is
+ * scored to the end of the game with the exact saving rules. A drone can
+ * rise now, fetch the k nearest fish first and then rise, or hold until
+ * the last turn, when all carried scans are saved anyway. A foe drone that
+ * is rising is expected to keep rising. Any other foe drone holds.
+ *
+ * Each pair of routes becomes a timeline of saves, scored the same way the
+ * referee scores it. The outcome depends only on the order of the saves,
+ * not on their turns. Outcomes are memoized in a table that stays valid
+ * from one turn to the next, and most turns only rescore a few timelines.
+ */
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <stdint.h>
+
+#include "engine.h"
+#include "surfacing.h"
+
+#define ENDGAME_TURNS (15)
+#define ENDGAME_MEMO_BITS (12)
+#define ENDGAME_ROUTES_MAX (SURFACING_CHAIN_MAX + 2)
+
+enum endgame_move {
+	ENDGAME_HOLD,
+	ENDGAME_RISE,
+	ENDGAME_FETCH,
+};
+
+struct endgame_route {
+	enum endgame_move move;
+	int target_id;   /* next fish to fetch, ENDGAME_FETCH only */
+	int save_turn;   /* turn the scans are saved on, GAME_TURN_MAX for the end of the game */
+	uint32_t saving; /* bit per FISH_INDEX() */
+};
+
+struct endgame_plan {
+	struct endgame_route routes[PLAYER_DRONE_COUNT]; /* same order as state.my.drones */
+	int delta;     /* predicted score difference gained until the end */
+	int scored;    /* timelines looked at */
+	int memo_hits;
+};
+
+static inline bool endgame_active(void) {
+	return GAME_TURN_MAX - ENDGAME_TURNS <= state.turn;
+}
+
+/* Forgets the memoized timelines, call once the creatures of a new game are known. */
+void endgame_reset(void);
+
+/* Needs surfacing_begin_turn() to have run this turn. */
+void endgame_solve(struct endgame_plan *plan);
+
+#endif
@@ -0,0 +1,267 @@
+#include "engine.h"
+#include <time.h>
+
+#include "trace.h"
+
+struct state state;
+
+static struct turn_commands *current_commands;
+static struct timespec startup_deadline;
+
+void assert(bool cond, char *fmt, ...) {
+	if (!cond) {
+		va_list args;
+		va_start(args, fmt);
+		vfprintf(stderr, fmt, args);
+		va_end(args);
+		abort();
+	}
+}
+
+void dbg(char *fmt, ...) {
+	(void)fmt;
+#ifdef DEBUG_BUILD
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+#endif
+}
+
+int abs_dist(int ax, int ay, int bx, int by) {
+	int dx = ax - bx;
+	int dy = ay - by;
+
+	return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
+
+void startup_begin(long budget_us) {
+	clock_gettime(CLOCK_MONOTONIC, &startup_deadline);
+	startup_deadline.tv_sec += budget_us / 1000000;
+	startup_deadline.tv_nsec += (budget_us % 1000000) * 1000;
+	if (1000000000 <= startup_deadline.tv_nsec) {
+		startup_deadline.tv_sec += 1;
+		startup_deadline.tv_nsec -= 1000000000;
+	}
+}
+
+bool startup_expired(void) {
+	if (!startup_deadline.tv_sec) { return false; }
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (startup_deadline.tv_sec < now.tv_sec) || (startup_deadline.tv_sec == now.tv_sec && startup_deadline.tv_nsec <= now.tv_nsec);
+}
+
+static struct drone_command *next_drone_command(void) {
+	assert(current_commands, "drone command submitted outside of plan_turn()\n");
+	assert(current_commands->count < state.my.drone_count, "too many drone commands\n");
+
+	struct drone_command *command = &current_commands->drones[current_commands->count];
+	current_commands->count += 1;
+	command->message[0] = '\0';
+	return command;
+}
+
+void submit_drone_move(int x, int y, int light, char *dbg, ...) {
+	struct drone_command *command = next_drone_command();
+	command->wait = false;
+	command->x = x;
+	command->y = y;
+	command->light = light;
+
+#ifndef DEBUG_BUILD
+	(void)dbg;
+#else
+	va_list varargs;
+	va_start(varargs, dbg);
+	vsnprintf(command->message, ARRLEN(command->message), dbg, varargs);
+	va_end(varargs);
+#endif
+}
+
+void submit_drone_wait(int light, char *dbg, ...) {
+	struct drone_command *command = next_drone_command();
+	command->wait = true;
+	command->light = light;
+
+#ifndef DEBUG_BUILD
+	(void)dbg;
+#else
+	va_list varargs;
+	va_start(varargs, dbg);
+	vsnprintf(command->message, ARRLEN(command->message), dbg, varargs);
+	va_end(varargs);
+#endif
+}
+
+void begin_round_input(void) {
+	for (int i = 0; i < TOTAL_DRONE_COUNT; i++) {
+		state.entities[i].drone.scan_count = 0;
+		state.entities[i].drone.blip_count = 0;
+	}
+
+	/* NOTE(benjamin): Drones are the first IDs so we can iterate on all fish by starting past them. */
+	for (int i = TOTAL_DRONE_COUNT; i < ARRLEN(state.entities); i++) {
+		state.entities[i].fish.visible = false;
+	}
+}
+
+void parse_game_input(void) {
+	int creature_count;
+	scanf("%d", &creature_count);
+	assert(
+		0 <= creature_count && creature_count <= FISH_COUNT + MONSTER_COUNT_MAX,
+		"Unexpected creature count: %d\n", creature_count
+	);
+
+	state.entity_count = TOTAL_DRONE_COUNT + creature_count;
+	state.turn = -1;
+
+	for (int i = 0; i < creature_count; i++) {
+		int id;
+		scanf("%d", &id);
+		assert(TOTAL_DRONE_COUNT <= id && id < ARRLEN(state.entities), "Unexpected creature id: %d\n", id);
+
+		struct fish *fish = &state.entities[id].fish;
+		scanf("%d%d", &fish->color, &fish->type);
+	}
+}
+
+static void parse_player_drones(struct player_state *player) {
+	scanf("%d", &player->drone_count);
+	assert(
+		1 <= player->drone_count && player->drone_count <= PLAYER_DRONE_COUNT,
+		"Unexpected number of drones: %d\n", player->drone_count
+	);
+
+	for (int i = 0; i < player->drone_count; i++) {
+		scanf("%d", &player->drones[i]);
+		assert(0 <= player->drones[i] && player->drones[i] < TOTAL_DRONE_COUNT, "Unexpected drone id: %d\n", player->drones[i]);
+
+		struct drone *drone = &state.entities[player->drones[i]].drone;
+		scanf("%d%d%d%d", &drone->x, &drone->y, &drone->emergency, &drone->battery);
+	}
+}
+
+static void parse_player_scans(struct player_state *player) {
+	scanf("%d", &player->scan_count);
+	assert(
+		0 <= player->scan_count && player->scan_count <= ARRLEN(player->scans),
+		"Unexpected scan count: %d\n", player->scan_count
+	);
+
+	for (int i = 0; i < player->scan_count; i++) {
+		scanf("%d", &player->scans[i]);
+	}
+}
+
+bool parse_round_input(void) {
+	begin_round_input();
+
+	if (scanf("%d%d", &state.my.score, &state.foe.score) != 2) { return false; }
+	state.turn += 1;
+	parse_player_scans(&state.my);
+	parse_player_scans(&state.foe);
+	parse_player_drones(&state.my);
+	parse_player_drones(&state.foe);
+
+	int drone_scan_count;
+	scanf("%d", &drone_scan_count);
+
+	for (int i = 0; i < drone_scan_count; i++) {
+		int drone_id;
+		int creature_id;
+		scanf("%d%d", &drone_id, &creature_id);
+
+		struct drone *drone = &state.entities[drone_id].drone;
+		assert(drone->scan_count < ARRLEN(drone->scans), "Drone scan overflow\n");
+		drone->scans[drone->scan_count] = creature_id;
+		drone->scan_count += 1;
+	}
+
+	int visible_creature_count;
+	scanf("%d", &visible_creature_count);
+
+	for (int i = 0; i < visible_creature_count; i++) {
+		int id;
+		scanf("%d", &id);
+
+		struct fish *fish = &state.entities[id].fish;
+		scanf("%d%d%d%d", &fish->x, &fish->y, &fish->vx, &fish->vy);
+		fish->visible = true;
+	}
+
+	int radar_blip_count;
+	scanf("%d", &radar_blip_count);
+
+	for (int i = 0; i < radar_blip_count; i++) {
+		int drone_id;
+		int creature_id;
+		char radar[3];
+		scanf("%d%d%2s", &drone_id, &creature_id, radar);
+		assert(
+			(radar[0] == 'T' || radar[0] == 'B') && (radar[1] == 'L' || radar[1] == 'R'),
+			"unkown direction: %s\n", radar
+		);
+
+		struct drone *drone = &state.entities[drone_id].drone;
+		assert(drone->blip_count < ARRLEN(drone->blips), "Drone blip overflow\n");
+		drone->blips[drone->blip_count].creature_id = creature_id;
+		drone->blips[drone->blip_count].direction = (radar[0] == 'T') | ((radar[1] == 'R') << 1);
+		drone->blip_count += 1;
+	}
+
+	return true;
+}
+
+void plan_turn(const struct strategy *strategy, struct turn_commands *commands) {
+	commands->count = 0;
+	current_commands = commands;
+	strategy->plan_turn();
+	current_commands = NULL;
+
+	assert(commands->count == state.my.drone_count, "%s submitted %d commands for %d drones\n",
+			strategy->name, commands->count, state.my.drone_count);
+}
+
+void print_turn_commands(const struct turn_commands *commands) {
+	for (int i = 0; i < commands->count; i++) {
+		const struct drone_command *command = &commands->drones[i];
+
+		char *separator = command->message[0] ? " " : "";
+
+		if (command->wait) {
+			printf("WAIT %d%s%s\n", command->light, separator, command->message);
+		} else {
+			printf("MOVE %d %d %d%s%s\n", command->x, command->y, command->light, separator, command->message);
+		}
+	}
+	fflush(stdout);
+}
+
+void engine_run(const struct strategy *strategy) {
+	struct turn_commands commands;
+
+	parse_game_input();
+	startup_begin(STARTUP_BUDGET_US);
+	strategy->init();
+
+	while (parse_round_input()) {
+		if (strategy->ponder_stop) { strategy->ponder_stop(); }
+
+		struct timespec start;
+		struct timespec end;
+		trace_begin_turn();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+		plan_turn(strategy, &commands);
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		print_turn_commands(&commands);
+		trace_end_turn(((end.tv_sec - start.tv_sec) * 1000000) + ((end.tv_nsec - start.tv_nsec) / 1000));
+
+		if (strategy->ponder_start) { strategy->ponder_start(); }
+	}
+	if (strategy->ponder_stop) { strategy->ponder_stop(); }
+}
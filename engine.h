@@ -0,0 +1,218 @@
+/*
+ * Engine core shared by every bot generation.
+ *
+ * Holds the game state, the input parser and the command helpers. Each bot is
+ * a struct strategy (see strategies.c) driven either by engine_run() over
+ * stdin/stdout or in-process by a match runner.
+ */
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#define ARRLEN(x) (sizeof(x) / sizeof(*x))
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+
+#if 0
+#define DEBUG_BUILD
+#endif
+
+#define MAX_X (10000)
+#define MAX_Y (10000)
+
+#define DRONE_BATTERY_MAX (30)
+
+#define DRONE_FISH_SCAN_DISTANCE (800)
+#define DRONE_TURN_MOVE_DISTANCE (600)
+#define DRONE_SCAN_SUBMIT_DEPTH (500)
+#define DRONE_SINK_DISTANCE (300)
+#define DRONE_EMERGENCY_RISE_DISTANCE (300)
+#define DRONE_LIGHT_SCAN_DISTANCE (2000)
+#define DRONE_LIGHT_BATTERY_COST (5)
+
+#define PLAYER_COUNT (2)
+#define PLAYER_DRONE_COUNT (2)
+#define TOTAL_DRONE_COUNT (PLAYER_DRONE_COUNT * PLAYER_COUNT)
+
+#define FISH_COLOR_COUNT (4)
+#define FISH_TYPE_COUNT (3)
+#define FISH_COUNT (FISH_COLOR_COUNT * FISH_TYPE_COUNT)
+
+#define MONSTER_COUNT_MAX (8) /* MIN is 1 */
+#define MONSTER_COLLISION_DISTANCE (500)
+
+#define GAME_TURN_MAX (200)
+
+#define FISH_SPEED (200)
+#define FISH_FLEE_SPEED (400)
+#define FISH_FLEE_DISTANCE (1400)
+#define FISH_SEPARATION_DISTANCE (600)
+
+#define MONSTER_SPEED (270)
+#define MONSTER_CHASE_SPEED (540)
+#define MONSTER_SEPARATION_DISTANCE (600)
+#define MONSTER_HABITAT_TOP (2500)
+
+/* Fish of a type stay in [FISH_HABITAT_TOP(type), FISH_HABITAT_BOTTOM(type)[, one band per type below the surface band. */
+#define FISH_HABITAT_HEIGHT (2500)
+#define FISH_HABITAT_TOP(type) (FISH_HABITAT_HEIGHT * ((type) + 1))
+#define FISH_HABITAT_BOTTOM(type) (FISH_HABITAT_TOP(type) + FISH_HABITAT_HEIGHT)
+
+/* 4 drones, 12 fish and up to 8 monsters from Bronze League on. */
+#define MAX_ENTITIES (TOTAL_DRONE_COUNT + FISH_COUNT + MONSTER_COUNT_MAX)
+
+/* NOTE(benjamin): Fish get the IDs right after the drones, monsters come last. */
+#define FISH_INDEX(id) ((id) - TOTAL_DRONE_COUNT)
+
+struct fish {
+	int color;    /* [0,3], -1 for monsters */
+	int type;     /* [0,2], -1 for monsters */
+	int x;        /* [0, 10000[ */
+	int y;        /* [0, 10000[ */
+	int vx;       /* [0, 10000[ ? */
+	int vy;       /* [0, 10000[ ? */
+	bool visible;
+	bool unavailable;
+	bool asymmetric; /* strategy bookkeeping, no longer mirrors its partner */
+	bool tracked;    /* strategy bookkeeping, x/y/vx/vy come from an observation */
+	int radar_left_x;   /* strategy bookkeeping, radar box carried over turns */
+	int radar_right_x;
+	int radar_top_y;
+	int radar_bottom_y;
+};
+
+enum direction {
+	BL,
+	TL,
+	BR,
+	TR,
+	NO_DIRECTION,
+};
+
+struct radar_blip {
+	int creature_id;
+	enum direction direction;
+};
+
+enum drone_state {
+	EMERGENCY,
+	STARTING_ROUTE,
+	ROUTING_DOWN,
+	ROUTING_UP,
+	SURFACING,
+};
+
+struct drone {
+	int x;         /* [0, 10000] */
+	int y;         /* [0, 10000] */
+	int emergency; /* ??? */
+	int battery;   /* [0, 30] */
+	int blip_count;
+	struct radar_blip blips[FISH_COUNT + MONSTER_COUNT_MAX];
+	int scan_count;
+	int scans[FISH_COUNT];
+
+	/* NOTE(benjamin): Strategy bookkeeping, the parser never touches these. */
+	enum drone_state state;
+	int turns_since_light;
+	int route_step;
+	int route_start_x;
+	int route_start_y;
+	int target_type;
+	int opening_step;
+	int opening_x;
+	int last_y;
+};
+
+union entity {
+	struct fish fish;
+	struct drone drone;
+};
+
+struct player_state {
+	int score;
+	int scan_count;
+	/* 3 types, 4 colors */
+	int scans[FISH_COUNT];
+	int drone_count;
+	int drones[PLAYER_DRONE_COUNT];
+};
+
+struct state {
+	int turn; /* [0, GAME_TURN_MAX[, scans still carried are saved once the last one is played */
+	struct player_state my;
+	struct player_state foe;
+	int entity_count;
+	union entity entities[MAX_ENTITIES];
+};
+
+extern struct state state;
+#define ENTITY_ID(ptr) ((union entity*)ptr - state.entities)
+
+struct drone_command {
+	bool wait;
+	int x;
+	int y;
+	int light;
+	char message[128];
+};
+
+struct turn_commands {
+	int count;
+	struct drone_command drones[PLAYER_DRONE_COUNT];
+};
+
+struct strategy {
+	char *name;
+	/* Called once the creatures are known, before the first turn. */
+	void (*init)(void);
+	/* Must submit exactly one command per drone in state.my.drones, in order. */
+	void (*plan_turn)(void);
+	/* Called by in-process match runners once the match is over, may be NULL. */
+	void (*on_result)(int my_score, int foe_score);
+	/* Called by engine_run() around the wait for the next round input, may be NULL. */
+	void (*ponder_start)(void);
+	void (*ponder_stop)(void);
+};
+
+void assert(bool cond, char *fmt, ...);
+void dbg(char *fmt, ...);
+
+int abs_dist(int ax, int ay, int bx, int by);
+
+void submit_drone_move(int x, int y, int light, char *dbg, ...);
+void submit_drone_wait(int light, char *dbg, ...);
+
+/* Resets everything that only lives for one round of input. */
+void begin_round_input(void);
+
+void parse_game_input(void);
+/* Returns false once the referee closed the input. */
+bool parse_round_input(void);
+
+void plan_turn(const struct strategy *strategy, struct turn_commands *commands);
+void print_turn_commands(const struct turn_commands *commands);
+
+/*
+ * The arena gives the first turn 1000 ms against 50 ms for the others.
+ * engine_run() opens a startup deadline over part of it before init(), the
+ * strategies build their lookup tables until startup_expired(). A table cut
+ * short can be resumed from ponder_start() under a new, shorter deadline.
+ * Without a deadline, as in the in-process runners, nothing ever expires.
+ */
+#define STARTUP_BUDGET_US (600000)
+
+void startup_begin(long budget_us);
+bool startup_expired(void);
+
+void engine_run(const struct strategy *strategy);
+
+extern const struct strategy *const strategies[];
+const struct strategy *find_strategy(char *name);
+
+#endif
@@ -0,0 +1,134 @@
+#include "eval.h"
+#include "intmath.h"
+
+#include "eval_weights.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define VALUE_SCALE (4)    /* fish values */
+#define DISTANCE_SCALE (8) /* map units */
+#define COUNT_SCALE (256)
+#define FLAG_SCALE (1024)
+#define MONSTER_CLOSE_DISTANCE (1500)
+
+/* NOTE(benjamin): abs_dist() lives in engine.c and would not get inlined in the leaf loops. */
+static inline int taxicab(int ax, int ay, int bx, int by) {
+	int dx = ax - bx;
+	int dy = ay - by;
+	return ((dx < 0) ? -dx : dx) + ((dy < 0) ? -dy : dy);
+}
+
+static int16_t clamp16(long value) {
+	return (int16_t)MAX(INT16_MIN, MIN(INT16_MAX, value));
+}
+
+void eval_features(const struct search_problem *problem, int ply, int x, int y, int battery, uint32_t scans, struct eval_features *features) {
+	long best_value = 0; /* best is best_value * DRONE_TURN_MOVE_DISTANCE / best_span, compared without dividing */
+	long best_span = 1;
+	long near = 0;
+	long mid = 0;
+	long far = 0;
+	long total = 0;
+	long lit = 0;
+	int left = 0;
+	int nearest_fish = MAX_X + MAX_Y;
+	bool light_ready = problem->light_min_depth < y && (2 * DRONE_LIGHT_BATTERY_COST) <= battery;
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		int value = problem->fish[i].value;
+		if (!value || (scans & (1u << i))) { continue; }
+
+		struct vec2d position = problem->fish_path[ply][i];
+		long d2 = dist2(x, y, position.x, position.y);
+		int dist = taxicab(x, y, position.x, position.y);
+
+		long span = DRONE_TURN_MOVE_DISTANCE + dist;
+		if (best_value * span < value * best_span) {
+			best_value = value;
+			best_span = span;
+		}
+		nearest_fish = MIN(nearest_fish, dist);
+		total += value;
+		left += 1;
+
+		long reach = DRONE_FISH_SCAN_DISTANCE + DRONE_TURN_MOVE_DISTANCE;
+		if (d2 <= reach * reach) { near += value; }
+		reach += DRONE_TURN_MOVE_DISTANCE;
+		if (d2 <= reach * reach) { mid += value; }
+		reach += 2 * DRONE_TURN_MOVE_DISTANCE;
+		if (d2 <= reach * reach) { far += value; }
+		if (light_ready && d2 <= (long)DRONE_LIGHT_SCAN_DISTANCE * DRONE_LIGHT_SCAN_DISTANCE) { lit += value; }
+	}
+
+	/* NOTE(benjamin): Nearest distances are taxicab, a square root per leaf costs more than the rest of the features. */
+	int nearest_monster = MAX_X + MAX_Y;
+	int monsters_close = 0;
+	for (int m = 0; m < problem->monster_count; m++) {
+		const struct search_creature *monster = &problem->monsters[m];
+		int mx = MAX(0, MIN(MAX_X - 1, monster->x + (monster->vx * ply)));
+		int my = MAX(0, MIN(MAX_Y - 1, monster->y + (monster->vy * ply)));
+		long d2 = dist2(x, y, mx, my);
+
+		nearest_monster = MIN(nearest_monster, taxicab(x, y, mx, my));
+		monsters_close += d2 <= (long)MONSTER_CLOSE_DISTANCE * MONSTER_CLOSE_DISTANCE;
+	}
+
+	int16_t *values = features->values;
+	memset(values, 0, sizeof(features->values));
+	values[EVAL_BIAS] = FLAG_SCALE;
+	values[EVAL_BEST_FISH] = clamp16(((best_value * DRONE_TURN_MOVE_DISTANCE) / best_span) / VALUE_SCALE);
+	values[EVAL_NEAR_VALUE] = clamp16(near / VALUE_SCALE);
+	values[EVAL_MID_VALUE] = clamp16(mid / VALUE_SCALE);
+	values[EVAL_FAR_VALUE] = clamp16(far / VALUE_SCALE);
+	values[EVAL_TOTAL_VALUE] = clamp16(total / VALUE_SCALE);
+	values[EVAL_FISH_LEFT] = clamp16((long)left * COUNT_SCALE);
+	values[EVAL_DEPTH] = clamp16(y / DISTANCE_SCALE);
+	values[EVAL_BATTERY] = clamp16((long)battery * COUNT_SCALE / 8);
+	values[EVAL_NEAREST_FISH] = clamp16(nearest_fish / DISTANCE_SCALE);
+	values[EVAL_NEAREST_MONSTER] = clamp16(nearest_monster / DISTANCE_SCALE);
+	values[EVAL_MONSTERS_CLOSE] = clamp16((long)monsters_close * COUNT_SCALE);
+	values[EVAL_LIGHT_READY] = light_ready ? FLAG_SCALE : 0;
+	values[EVAL_LIT_VALUE] = clamp16(lit / VALUE_SCALE);
+}
+
+#if defined(__AVX2__)
+static int dot(const int16_t *features, const int8_t *weights) {
+	__m256i f = _mm256_load_si256((const __m256i *)features);
+	__m256i w = _mm256_cvtepi8_epi16(_mm_load_si128((const __m128i *)weights));
+	__m256i products = _mm256_madd_epi16(f, w);
+
+	__m128i sums = _mm_add_epi32(_mm256_castsi256_si128(products), _mm256_extracti128_si256(products, 1));
+	sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4e));
+	sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0xb1));
+	return _mm_cvtsi128_si32(sums);
+}
+#elif defined(__SSE2__)
+static int dot(const int16_t *features, const int8_t *weights) {
+	__m128i w = _mm_load_si128((const __m128i *)weights);
+	/* NOTE(benjamin): No cvtepi8 before SSE4.1, doubling the bytes then shifting sign extends them. */
+	__m128i w_low = _mm_srai_epi16(_mm_unpacklo_epi8(w, w), 8);
+	__m128i w_high = _mm_srai_epi16(_mm_unpackhi_epi8(w, w), 8);
+
+	__m128i sums = _mm_add_epi32(
+		_mm_madd_epi16(_mm_load_si128((const __m128i *)features), w_low),
+		_mm_madd_epi16(_mm_load_si128((const __m128i *)(features + 8)), w_high)
+	);
+	sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4e));
+	sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0xb1));
+	return _mm_cvtsi128_si32(sums);
+}
+#else
+static int dot(const int16_t *features, const int8_t *weights) {
+	int sum = 0;
+	for (int i = 0; i < EVAL_FEATURES; i++) {
+		sum += features[i] * weights[i];
+	}
+	return sum;
+}
+#endif
+
+int eval_score(const struct eval_features *features) {
+	return dot(features->values, eval_weights) >> EVAL_WEIGHT_SHIFT;
+}
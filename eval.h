@@ -0,0 +1,51 @@
+/*
+ * Learned leaf evaluation for the search, a linear model over a fixed
+ * feature vector of the drone at a leaf.
+ *
+ * Features are int16 and the weights int8, generated by eval_train into
+ * eval_weights.h. The dot product is a single AVX2 multiply-add of the 16
+ * lanes, two with SSE2, plain C elsewhere. The weights are fitted to the
+ * value a two ply deeper search finds, so a leaf scored with them sees a bit
+ * past the search horizon.
+ */
+#ifndef EVAL_H
+#define EVAL_H
+
+#include <stdint.h>
+
+#include "search.h"
+
+enum eval_feature {
+	EVAL_BIAS,
+	EVAL_BEST_FISH,  /* leaf value of the plain search, best remaining fish discounted by distance */
+	EVAL_NEAR_VALUE, /* unscanned fish value within a move and the scan distance */
+	EVAL_MID_VALUE,  /* within two moves */
+	EVAL_FAR_VALUE,  /* within four moves */
+	EVAL_TOTAL_VALUE,
+	EVAL_FISH_LEFT,
+	EVAL_DEPTH,
+	EVAL_BATTERY,
+	EVAL_NEAREST_FISH,
+	EVAL_NEAREST_MONSTER,
+	EVAL_MONSTERS_CLOSE,
+	EVAL_LIGHT_READY,
+	EVAL_LIT_VALUE, /* unscanned fish value within the light distance, when the light is ready */
+	EVAL_FEATURE_COUNT
+};
+
+#define EVAL_FEATURES (16) /* EVAL_FEATURE_COUNT padded to a vector of int16 */
+
+struct eval_features {
+	int16_t values[EVAL_FEATURES];
+} __attribute__((aligned(32)));
+
+void eval_features(const struct search_problem *problem, int ply, int x, int y, int battery, uint32_t scans, struct eval_features *features);
+int eval_score(const struct eval_features *features);
+
+static inline int eval_leaf(const struct search_problem *problem, int ply, int x, int y, int battery, uint32_t scans) {
+	struct eval_features features;
+	eval_features(problem, ply, x, y, battery, scans, &features);
+	return eval_score(&features);
+}
+
+#endif
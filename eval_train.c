@@ -0,0 +1,186 @@
+/*
+ * Fits the learned leaf evaluation of the search.
+ *
+ *     cc -O2 -o eval_train eval_train.c match.c referee.c engine.c strategies.c movement.c symmetry.c radar.c danger.c intmath.c surfacing.c endgame.c foe.c lure.c rhea.c eval.c record.c pool.c trace.c fishsim.c tt.c search.c mark*.c node-chaser_mk1.c -lm -pthread
+ *     ./eval_train [games] [seed] > eval_weights.h
+ *
+ * mark4 plays node-chaser_mk1 and every problem its searches are given
+ * becomes a sample: the features of the drone at the root against the value
+ * a plain two ply search finds from there. A ridge least squares fit over
+ * four fifths of the samples gives the weights, quantized to int8 with the
+ * largest shift that keeps them in range. The errors on the last fifth are
+ * printed to stderr next to the plain leaf value's.
+ */
+#include <math.h>
+
+#include "eval.h"
+#include "mark4.h"
+#include "match.h"
+
+#define TEACHER_DEPTH (2)
+#define TEACHER_TT_BUCKET_BITS (12)
+#define RIDGE (1e-4) /* relative to the feature's own variance */
+
+struct sample {
+	struct eval_features features;
+	int target;
+};
+
+static struct sample *samples;
+static long sample_count;
+static long sample_capacity;
+static struct transposition_table teacher_tt;
+
+static void sample_problem(const struct search_problem *problem) {
+	/* NOTE(benjamin): A trapped drone is worth minus a million, one of them would drive the whole fit. */
+	int target = search_subtree_value(problem, &teacher_tt, TEACHER_DEPTH);
+	if (target < 0) { return; }
+
+	if (sample_count == sample_capacity) {
+		sample_capacity = sample_capacity ? 2 * sample_capacity : 4096;
+		samples = realloc(samples, sample_capacity * sizeof(*samples));
+		assert(samples, "out of memory for %ld samples\n", sample_capacity);
+	}
+
+	struct sample *sample = &samples[sample_count];
+	eval_features(problem, 0, problem->drone_x, problem->drone_y, problem->battery, problem->scans, &sample->features);
+	sample->target = target;
+	sample_count += 1;
+}
+
+/* Solves a x = b in place, Gaussian elimination with partial pivoting. */
+static void solve(double a[EVAL_FEATURE_COUNT][EVAL_FEATURE_COUNT], double b[EVAL_FEATURE_COUNT], double x[EVAL_FEATURE_COUNT]) {
+	int n = EVAL_FEATURE_COUNT;
+
+	for (int col = 0; col < n; col++) {
+		int pivot = col;
+		for (int row = col + 1; row < n; row++) {
+			if (fabs(a[pivot][col]) < fabs(a[row][col])) { pivot = row; }
+		}
+		assert(a[pivot][col] != 0, "singular features, column %d\n", col);
+
+		for (int k = 0; k < n; k++) {
+			double swap = a[col][k];
+			a[col][k] = a[pivot][k];
+			a[pivot][k] = swap;
+		}
+		double swap = b[col];
+		b[col] = b[pivot];
+		b[pivot] = swap;
+
+		for (int row = col + 1; row < n; row++) {
+			double factor = a[row][col] / a[col][col];
+			for (int k = col; k < n; k++) {
+				a[row][k] -= factor * a[col][k];
+			}
+			b[row] -= factor * b[col];
+		}
+	}
+
+	for (int row = n - 1; 0 <= row; row--) {
+		double sum = b[row];
+		for (int k = row + 1; k < n; k++) {
+			sum -= a[row][k] * x[k];
+		}
+		x[row] = sum / a[row][row];
+	}
+}
+
+static void fit(long count, double weights[EVAL_FEATURE_COUNT]) {
+	static double a[EVAL_FEATURE_COUNT][EVAL_FEATURE_COUNT];
+	double b[EVAL_FEATURE_COUNT] = {};
+
+	for (long s = 0; s < count; s++) {
+		const int16_t *f = samples[s].features.values;
+		for (int i = 0; i < EVAL_FEATURE_COUNT; i++) {
+			for (int j = 0; j < EVAL_FEATURE_COUNT; j++) {
+				a[i][j] += (double)f[i] * f[j];
+			}
+			b[i] += (double)f[i] * samples[s].target;
+		}
+	}
+
+	/* NOTE(benjamin): Features that never show up (no light in the samples) would leave the system singular. */
+	for (int i = 0; i < EVAL_FEATURE_COUNT; i++) {
+		a[i][i] += (RIDGE * a[i][i]) + 1;
+	}
+
+	solve(a, b, weights);
+}
+
+static double rms_error(long begin, long end, const double weights[EVAL_FEATURE_COUNT], int shift, const int8_t *quantized) {
+	double sum = 0;
+
+	for (long s = begin; s < end; s++) {
+		const int16_t *f = samples[s].features.values;
+		double predicted = 0;
+		for (int i = 0; i < EVAL_FEATURE_COUNT; i++) {
+			predicted += quantized ? ldexp(quantized[i], -shift) * f[i] : weights[i] * f[i];
+		}
+
+		double error = predicted - samples[s].target;
+		sum += error * error;
+	}
+
+	return sqrt(sum / MAX(1, end - begin));
+}
+
+int main(int argc, char **argv)
+{
+	int games = (2 <= argc) ? atoi(argv[1]) : 100;
+	uint64_t seed = (3 <= argc) ? strtoull(argv[2], NULL, 0) : 1;
+
+	const struct strategy *foe = find_strategy("node-chaser_mk1");
+	assert(foe, "node-chaser_mk1 is not registered\n");
+
+	mark4_search_threads = 1;
+	tt_init(&teacher_tt, TEACHER_TT_BUCKET_BITS);
+
+	for (int i = 0; i < games; i++) {
+		int swap = i % 2;
+		const struct strategy *players[PLAYER_COUNT] = { swap ? foe : &mark4_strategy, swap ? &mark4_strategy : foe };
+		struct match_result result;
+
+		search_problem_hook = sample_problem;
+		play_match(players, seed + (i / 2), &result);
+		search_problem_hook = NULL;
+	}
+
+	long train_count = (sample_count * 4) / 5;
+	assert(EVAL_FEATURE_COUNT < train_count, "only %ld samples\n", sample_count);
+
+	double weights[EVAL_FEATURE_COUNT];
+	fit(train_count, weights);
+
+	double largest = 0;
+	for (int i = 0; i < EVAL_FEATURE_COUNT; i++) {
+		largest = MAX(largest, fabs(weights[i]));
+	}
+	assert(largest < INT8_MAX, "weights up to %.1f do not fit in int8, scale the features down\n", largest);
+
+	int shift = 0;
+	while (shift < 14 && ldexp(largest, shift + 1) < INT8_MAX) {
+		shift += 1;
+	}
+
+	int8_t quantized[EVAL_FEATURES] = {};
+	for (int i = 0; i < EVAL_FEATURE_COUNT; i++) {
+		quantized[i] = (int8_t)lround(ldexp(weights[i], shift));
+	}
+
+	double plain[EVAL_FEATURE_COUNT] = { [EVAL_BEST_FISH] = 4 };
+	fprintf(stderr, "%ld samples, holdout rms error: plain leaf %.1f, fitted %.1f, int8 %.1f\n", sample_count,
+			rms_error(train_count, sample_count, plain, 0, NULL),
+			rms_error(train_count, sample_count, weights, 0, NULL),
+			rms_error(train_count, sample_count, weights, shift, quantized));
+
+	printf("/* Generated by eval_train (%d games, seed %llu), do not edit. */\n", games, (unsigned long long)seed);
+	printf("#define EVAL_WEIGHT_SHIFT (%d)\n\n", shift);
+	printf("static const int8_t eval_weights[EVAL_FEATURES] __attribute__((aligned(16))) = {\n\t");
+	for (int i = 0; i < EVAL_FEATURES; i++) {
+		printf("%d,%s", quantized[i], (i + 1 < EVAL_FEATURES) ? " " : "\n");
+	}
+	printf("};\n");
+
+	return 0;
+}
@@ -0,0 +1,6 @@
+/* Generated by eval_train (200 games, seed 9001), do not edit. */
+#define EVAL_WEIGHT_SHIFT (4)
+
+static const int8_t eval_weights[EVAL_FEATURES] __attribute__((aligned(16))) = {
+	-1, 83, 1, 17, 19, 0, 1, 0, 2, 0, 0, -1, 2, 21, 0, 0,
+};
@@ -0,0 +1,124 @@
+#include <math.h>
+
+#include "fishsim.h"
+
+void fish_school_from_state(struct fish_school *school) {
+	memset(school, 0, sizeof(*school));
+
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *fish = &state.entities[id].fish;
+		if (fish->type == -1) { continue; }
+
+		int lane = FISH_INDEX(id);
+		school->x[lane] = fish->x;
+		school->y[lane] = fish->y;
+		school->vx[lane] = fish->vx;
+		school->vy[lane] = fish->vy;
+		school->top[lane] = FISH_HABITAT_TOP(fish->type);
+		school->bottom[lane] = FISH_HABITAT_BOTTOM(fish->type) - 1;
+		school->alive[lane] = !fish->unavailable;
+	}
+}
+
+void fish_drones_from_state(struct fish_drones *drones) {
+	drones->count = 0;
+
+	for (int id = 0; id < TOTAL_DRONE_COUNT; id++) {
+		struct drone *drone = &state.entities[id].drone;
+		if (drone->emergency) { continue; }
+
+		drones->x[drones->count] = drone->x;
+		drones->y[drones->count] = drone->y;
+		drones->count += 1;
+	}
+}
+
+/* NOTE(benjamin): Plain comparisons and casts, fminf() and roundf() end up as libm calls that block the vectorizer. */
+static inline float min_f(float a, float b) { return (a < b) ? a : b; }
+static inline float max_f(float a, float b) { return (a < b) ? b : a; }
+static inline float round_f(float a) { return (float)(int)(a + ((a < 0) ? -0.5f : 0.5f)); }
+
+static void move(struct fish_school *s) {
+	for (int i = 0; i < FISH_SCHOOL_LANES; i++) {
+		float x = s->x[i] + s->vx[i];
+		float y = s->y[i] + s->vy[i];
+		float outside = (float)((x < 0) | (MAX_X <= x));
+
+		/* NOTE(benjamin): Fleeing through a side leaves the game, anything else stops at the edge. */
+		s->alive[i] = s->alive[i] * (1.0f - (outside * s->fleeing[i]));
+		s->x[i] = min_f(max_f(x, 0), MAX_X - 1);
+		s->y[i] = min_f(max_f(y, s->top[i]), s->bottom[i]);
+	}
+}
+
+static void update_speeds(struct fish_school *s, const struct fish_drones *drones) {
+	float flee_x[FISH_SCHOOL_LANES] = {};
+	float flee_y[FISH_SCHOOL_LANES] = {};
+	float flee[FISH_SCHOOL_LANES] = {}; /* drones in range */
+
+	for (int d = 0; d < drones->count; d++) {
+		float drone_x = drones->x[d];
+		float drone_y = drones->y[d];
+
+		for (int i = 0; i < FISH_SCHOOL_LANES; i++) {
+			float dx = s->x[i] - drone_x;
+			float dy = s->y[i] - drone_y;
+			float in_range = (float)(((dx * dx) + (dy * dy)) <= (float)FISH_FLEE_DISTANCE * FISH_FLEE_DISTANCE);
+
+			flee_x[i] += in_range * dx;
+			flee_y[i] += in_range * dy;
+			flee[i] += in_range;
+		}
+	}
+
+	float away_x[FISH_SCHOOL_LANES];
+	float away_y[FISH_SCHOOL_LANES];
+	float best_d2[FISH_SCHOOL_LANES];
+	for (int i = 0; i < FISH_SCHOOL_LANES; i++) {
+		away_x[i] = s->vx[i];
+		away_y[i] = s->vy[i];
+		best_d2[i] = (float)FISH_SEPARATION_DISTANCE * FISH_SEPARATION_DISTANCE;
+	}
+
+	for (int other = 0; other < FISH_SCHOOL_LANES; other++) {
+		if (!s->alive[other]) { continue; }
+
+		for (int i = 0; i < FISH_SCHOOL_LANES; i++) {
+			float dx = s->x[i] - s->x[other];
+			float dy = s->y[i] - s->y[other];
+			float d2 = (dx * dx) + (dy * dy);
+			int closer = (i != other) & (d2 <= best_d2[i]);
+
+			best_d2[i] = closer ? d2 : best_d2[i];
+			away_x[i] = closer ? dx : away_x[i];
+			away_y[i] = closer ? dy : away_y[i];
+		}
+	}
+
+	for (int i = 0; i < FISH_SCHOOL_LANES; i++) {
+		int fleeing = (0 < flee[i]);
+		float dx = fleeing ? flee_x[i] : away_x[i];
+		float dy = fleeing ? flee_y[i] : away_y[i];
+		float speed = fleeing ? FISH_FLEE_SPEED : FISH_SPEED;
+		float length = __builtin_sqrtf((dx * dx) + (dy * dy));
+		float scale = (0 < length) ? (speed / length) : 0;
+
+		float vx = round_f(dx * scale);
+		float vy = round_f(dy * scale);
+
+		float next_y = s->y[i] + vy;
+		vy = ((next_y < s->top[i]) | (s->bottom[i] < next_y)) ? -vy : vy;
+
+		float next_x = s->x[i] + vx;
+		vx = ((fleeing == 0) & ((next_x < 0) | (MAX_X <= next_x))) ? -vx : vx;
+
+		s->vx[i] = vx * s->alive[i];
+		s->vy[i] = vy * s->alive[i];
+		s->fleeing[i] = (float)fleeing;
+	}
+}
+
+void fish_school_step(struct fish_school *school, const struct fish_drones *drones) {
+	move(school);
+	update_speeds(school, drones);
+}
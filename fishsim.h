@@ -0,0 +1,44 @@
+/*
+ * Fish dynamics, following the rules of referee.c: fleeing from drones in
+ * range, separation from the closest fish, edge and habitat bounces and
+ * leaving the map when fleeing through a side. Only checked against
+ * referee.c, whose rules were written from the game statement, never against
+ * frames of real games.
+ *
+ * The school is kept as structure of arrays padded to FISH_SCHOOL_LANES so
+ * every rule is a fixed length loop over all the fish the compiler turns
+ * into vector code. Dead or padding lanes are masked out with alive = 0.
+ */
+#ifndef FISHSIM_H
+#define FISHSIM_H
+
+#include "engine.h"
+
+#define FISH_SCHOOL_LANES (16)
+
+struct fish_school {
+	float x[FISH_SCHOOL_LANES];
+	float y[FISH_SCHOOL_LANES];
+	float vx[FISH_SCHOOL_LANES];
+	float vy[FISH_SCHOOL_LANES];
+	float top[FISH_SCHOOL_LANES];    /* habitat band, inclusive */
+	float bottom[FISH_SCHOOL_LANES];
+	float alive[FISH_SCHOOL_LANES];  /* 1 or 0 */
+	float fleeing[FISH_SCHOOL_LANES];
+} __attribute__((aligned(64)));
+
+struct fish_drones {
+	int count;
+	float x[TOTAL_DRONE_COUNT];
+	float y[TOTAL_DRONE_COUNT];
+};
+
+/* Lane FISH_INDEX(id) of every fish of the engine state, unavailable fish are dead. */
+void fish_school_from_state(struct fish_school *school);
+/* Every drone of the engine state that is not in emergency. */
+void fish_drones_from_state(struct fish_drones *drones);
+
+/* One referee turn: move with the current speeds, then pick the speeds of the next turn. */
+void fish_school_step(struct fish_school *school, const struct fish_drones *drones);
+
+#endif
@@ -0,0 +1,106 @@
+#include "foe.h"
+#include "intmath.h"
+#include "surfacing.h"
+
+void foe_from_state(struct foe_forecast *forecast) {
+	forecast->count = state.foe.drone_count;
+	forecast->scanned = 0;
+
+	for (int i = 0; i < state.foe.scan_count; i++) {
+		forecast->scanned |= 1u << FISH_INDEX(state.foe.scans[i]);
+	}
+
+	for (int i = 0; i < forecast->count; i++) {
+		int id = state.foe.drones[i];
+		struct drone *drone = &state.entities[id].drone;
+		struct foe_drone *foe = &forecast->drones[i];
+
+		/* NOTE(benjamin): Same lanes as fish_drones_from_state(), drones in emergency have none. */
+		int lane = 0;
+		for (int other = 0; other < id; other++) {
+			lane += !state.entities[other].drone.emergency;
+		}
+
+		int carried = 0;
+		for (int s = 0; s < drone->scan_count; s++) {
+			uint32_t bit = 1u << FISH_INDEX(drone->scans[s]);
+			carried += !(forecast->scanned & bit);
+			forecast->scanned |= bit;
+		}
+
+		*foe = (struct foe_drone){
+			.x = drone->x,
+			.y = drone->y,
+			.lane = drone->emergency ? -1 : lane,
+			.carried = carried,
+			.rising = carried && surfacing_rising(id),
+			.alive = !drone->emergency,
+		};
+	}
+}
+
+static int nearest_fish(const struct foe_forecast *forecast, const struct foe_drone *foe, const struct fish_school *school) {
+	int nearest = -1;
+	long nearest_dist2 = 0;
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (!school->alive[i] || (forecast->scanned & (1u << i))) { continue; }
+
+		long d2 = dist2(foe->x, foe->y, (int)school->x[i], (int)school->y[i]);
+		if (nearest == -1 || d2 < nearest_dist2) {
+			nearest = i;
+			nearest_dist2 = d2;
+		}
+	}
+
+	return nearest;
+}
+
+static void move_towards(struct foe_drone *foe, int x, int y) {
+	int distance = int_distance(foe->x, foe->y, x, y);
+	if (distance <= DRONE_TURN_MOVE_DISTANCE) {
+		foe->x = x;
+		foe->y = y;
+		return;
+	}
+
+	foe->x += (int)(((long)(x - foe->x) * DRONE_TURN_MOVE_DISTANCE) / distance);
+	foe->y += (int)(((long)(y - foe->y) * DRONE_TURN_MOVE_DISTANCE) / distance);
+}
+
+void foe_step(struct foe_forecast *forecast, const struct fish_school *school, struct fish_drones *drones) {
+	for (int i = 0; i < forecast->count; i++) {
+		struct foe_drone *foe = &forecast->drones[i];
+		if (!foe->alive) { continue; }
+
+		int target = -1;
+		if (!foe->rising && foe->carried < FOE_CARRY_MAX) {
+			target = nearest_fish(forecast, foe, school);
+		}
+		foe->rising = foe->carried && target == -1;
+
+		if (foe->rising) {
+			move_towards(foe, foe->x, DRONE_SCAN_SUBMIT_DEPTH);
+		} else if (target != -1) {
+			move_towards(foe, (int)school->x[target], (int)school->y[target]);
+		}
+
+		for (int f = 0; f < FISH_COUNT; f++) {
+			if (!school->alive[f] || (forecast->scanned & (1u << f))) { continue; }
+			if (!within(foe->x, foe->y, (int)school->x[f], (int)school->y[f], DRONE_FISH_SCAN_DISTANCE)) { continue; }
+
+			forecast->scanned |= 1u << f;
+			foe->carried += 1;
+		}
+
+		if (foe->y <= DRONE_SCAN_SUBMIT_DEPTH) {
+			foe->carried = 0;
+			foe->rising = false;
+		}
+
+		if (foe->lane != -1) {
+			drones->x[foe->lane] = foe->x;
+			drones->y[foe->lane] = foe->y;
+		}
+	}
+}
@@ -0,0 +1,44 @@
+/*
+ * Opponent model, a greedy guess of where the foe drones go next.
+ *
+ * Every foe drone heads straight for the nearest fish its player has not
+ * scanned yet and surfaces once it carries FOE_CARRY_MAX scans, has nothing
+ * left to fetch or was already rising with scans. A step is one pass over
+ * the fish per drone, cheap enough to run inside every playout.
+ *
+ * The forecast moves the foe drones in a struct fish_drones filled by
+ * fish_drones_from_state() so the rolled fish flee from where the foe is
+ * going rather than from where it was.
+ */
+#ifndef FOE_H
+#define FOE_H
+
+#include <stdint.h>
+
+#include "engine.h"
+#include "fishsim.h"
+
+#define FOE_CARRY_MAX (4)
+
+struct foe_drone {
+	int x;
+	int y;
+	int lane;    /* index in the fish_drones_from_state() arrays */
+	int carried; /* scans not saved yet */
+	bool rising;
+	bool alive;
+};
+
+struct foe_forecast {
+	int count;
+	struct foe_drone drones[PLAYER_DRONE_COUNT];
+	uint32_t scanned; /* bit per FISH_INDEX(), saved or carried by the foe */
+};
+
+/* The foe drones of the engine state, after surfacing_begin_turn(). */
+void foe_from_state(struct foe_forecast *forecast);
+
+/* One turn of the foe drones against the fish of school, their lanes in drones follow. */
+void foe_step(struct foe_forecast *forecast, const struct fish_school *school, struct fish_drones *drones);
+
+#endif
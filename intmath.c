@@ -0,0 +1,66 @@
+#include <math.h>
+
+#include "intmath.h"
+
+int isqrt(long n) {
+	if (n <= 0) { return 0; }
+
+	/* NOTE(benjamin): Digit by digit in base 4, starting from the highest power of 4 not above n. */
+	long bit = 1L << ((63 - __builtin_clzl(n)) & ~1);
+	long root = 0;
+
+	while (bit) {
+		if (root + bit <= n) {
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (int)root;
+}
+
+struct intmath_errors intmath_check(void) {
+	struct intmath_errors worst = {};
+
+	/* NOTE(benjamin): Every square and its neighbours up to the map diagonal, plus a sweep in between. */
+	for (long root = 0; root <= 15000; root++) {
+		for (long n = (root * root) - 1; n <= (root * root) + 1; n++) {
+			if (n < 0) { continue; }
+			int error = abs(isqrt(n) - (int)sqrt((double)n));
+			assert(!error, "isqrt(%ld) = %d\n", n, isqrt(n));
+			worst.isqrt = MAX(worst.isqrt, error);
+		}
+	}
+	for (long n = 0; n <= 2L * MAX_X * MAX_X; n += 9973) {
+		int error = abs(isqrt(n) - (int)sqrt((double)n));
+		assert(!error, "isqrt(%ld) = %d\n", n, isqrt(n));
+		worst.isqrt = MAX(worst.isqrt, error);
+	}
+
+	int const values[] = { -2000, -1, 0, 1, 7, 100, 999, 12345, 100000 };
+	for (int v = 0; v < ARRLEN(values); v++) {
+		for (int initial = 1; initial <= 15000; initial += 37) {
+			for (int final = 0; final <= 15000; final += 41) {
+				double exact = values[v] * (1.0 - ((double)final / initial));
+				int error = abs(progress_value(values[v], initial, final) - (int)exact);
+				assert(error <= 1, "progress_value(%d, %d, %d) off by %d\n", values[v], initial, final, error);
+				worst.progress_value = MAX(worst.progress_value, error);
+			}
+		}
+	}
+
+	for (int a = 0; a <= MAX_X; a += 53) {
+		for (int b = 0; b <= MAX_X; b += 59) {
+			if (!(a + b)) { continue; }
+			double exact = (((double)a * a) + ((double)b * b)) / (((double)a + b) * ((double)a + b));
+			double error = fabs(((double)fixed_kept_share(a, b) / FIXED_ONE) - exact);
+			assert(error <= 1.0 / FIXED_ONE, "fixed_kept_share(%d, %d) off by %g\n", a, b, error);
+			worst.kept_share = MAX(worst.kept_share, error);
+		}
+	}
+
+	return worst;
+}
@@ -0,0 +1,67 @@
+/*
+ * Integer distance and ratio helpers for the per-turn scoring.
+ *
+ * Thresholds are compared on squared distances, the few places that need an
+ * actual distance or ratio use an integer square root and 16.16 fixed point.
+ * intmath_check() asserts the error bounds against floating point, see
+ * runner --check.
+ */
+#ifndef INTMATH_H
+#define INTMATH_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+#define FIXED_SHIFT (16)
+#define FIXED_ONE (1 << FIXED_SHIFT)
+
+static inline long dist2(int ax, int ay, int bx, int by) {
+	long dx = ax - bx;
+	long dy = ay - by;
+	return (dx * dx) + (dy * dy);
+}
+
+static inline bool within(int ax, int ay, int bx, int by, int distance) {
+	return dist2(ax, ay, bx, by) <= (long)distance * distance;
+}
+
+/* Floor of the square root, exact. */
+int isqrt(long n);
+
+static inline int int_distance(int ax, int ay, int bx, int by) {
+	return isqrt(dist2(ax, ay, bx, by));
+}
+
+/* value * (1 - final / initial) rounded toward zero, off by at most one from the real product. */
+static inline int progress_value(int value, int initial, int final) {
+	initial = MAX(1, initial);
+	return (int)(((long)value * (initial - final)) / initial);
+}
+
+/* (a^2 + b^2) / (a + b)^2 in fixed point, the share of a segment a cut at a leaves on average. */
+static inline int fixed_kept_share(int a, int b) {
+	long total = (long)a + b;
+	if (total <= 0) { return FIXED_ONE; }
+	return (int)(((((long)a * a) + ((long)b * b)) << FIXED_SHIFT) / (total * total));
+}
+
+/* NOTE(benjamin): xorshift64, the referee generator is not linked into the bot. */
+static inline uint32_t next_random(uint64_t *rng) {
+	*rng ^= *rng << 13;
+	*rng ^= *rng >> 7;
+	*rng ^= *rng << 17;
+	return (uint32_t)(*rng >> 32);
+}
+
+/* Largest error intmath_check() saw for each helper, in the units of its result. */
+struct intmath_errors {
+	int isqrt;
+	int progress_value;
+	double kept_share;
+};
+
+/* Asserts the bounds above, slow, meant for debug builds and runner --check. */
+struct intmath_errors intmath_check(void);
+
+#endif
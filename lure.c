@@ -0,0 +1,161 @@
+#include <limits.h>
+
+#include "intmath.h"
+#include "lure.h"
+
+/* NOTE(benjamin): The foe still takes the first bonus for a fish I have not saved, twice the points. */
+static int carried_points(const struct drone *drone) {
+	int points = 0;
+
+	for (int i = 0; i < drone->scan_count; i++) {
+		int id = drone->scans[i];
+		bool mine = false;
+		for (int s = 0; s < state.my.scan_count; s++) {
+			mine |= state.my.scans[s] == id;
+		}
+		points += (state.entities[id].fish.type + 1) * (mine ? 1 : 2);
+	}
+
+	return points;
+}
+
+bool lure_begin(struct lure_setup *setup, const struct drone *drone, const struct foe_forecast *foe, const struct fish_school *school) {
+	setup->monster_count = 0;
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *fish = &state.entities[id].fish;
+		if (fish->type != -1 || !fish->visible) { continue; }
+
+		setup->monsters[setup->monster_count] = (struct lure_monster){ fish->x, fish->y, fish->vx, fish->vy };
+		setup->monster_count += 1;
+	}
+
+	int partner_id = (state.my.drones[0] == ENTITY_ID(drone)) ? state.my.drones[1] : state.my.drones[0];
+	struct drone *partner = &state.entities[partner_id].drone;
+	setup->partner = (struct vec2d){ partner->x, partner->y };
+
+	bool carrying = false;
+	setup->foe_count = foe->count;
+	for (int i = 0; i < foe->count; i++) {
+		struct drone *foe_drone = &state.entities[state.foe.drones[i]].drone;
+		setup->foe_alive[i] = foe->drones[i].alive;
+		setup->foe_points[i] = foe->drones[i].carried ? carried_points(foe_drone) : 0;
+		setup->foe_path[0][i] = (struct vec2d){ foe->drones[i].x, foe->drones[i].y };
+		carrying |= setup->foe_alive[i] && setup->foe_points[i];
+	}
+	if (!carrying || !setup->monster_count) { return false; }
+
+	struct foe_forecast rolled = *foe;
+	struct fish_school fish = *school;
+	struct fish_drones drones;
+	fish_drones_from_state(&drones);
+
+	for (int turn = 1; turn <= LURE_TURNS + 1; turn++) {
+		foe_step(&rolled, &fish, &drones);
+		fish_school_step(&fish, &drones);
+
+		for (int i = 0; i < foe->count; i++) {
+			setup->foe_path[turn][i] = (struct vec2d){ rolled.drones[i].x, rolled.drones[i].y };
+		}
+	}
+
+	return true;
+}
+
+static void set_speed(struct lure_monster *monster, int dx, int dy, int speed) {
+	int length = int_distance(0, 0, dx, dy);
+	if (!length) {
+		monster->vx = 0;
+		monster->vy = 0;
+		return;
+	}
+
+	monster->vx = (int)(((long)dx * speed) / length);
+	monster->vy = (int)(((long)dy * speed) / length);
+}
+
+/* Referee rule, the closest drone whose light reaches the monster sets its chase. */
+static bool retarget(struct lure_monster *monster, const struct vec2d *drones, const int *ranges, int count, int *target) {
+	long best_dist2 = LONG_MAX;
+	*target = -1;
+
+	for (int d = 0; d < count; d++) {
+		long d2 = dist2(monster->x, monster->y, drones[d].x, drones[d].y);
+		if (d2 <= (long)ranges[d] * ranges[d] && d2 < best_dist2) {
+			best_dist2 = d2;
+			*target = d;
+		}
+	}
+
+	if (*target != -1) {
+		set_speed(monster, drones[*target].x - monster->x, drones[*target].y - monster->y, MONSTER_CHASE_SPEED);
+	} else if (monster->vx || monster->vy) {
+		set_speed(monster, monster->vx, monster->vy, MONSTER_SPEED);
+	}
+
+	int next_x = monster->x + monster->vx;
+	int next_y = monster->y + monster->vy;
+	if (next_x < 0 || MAX_X <= next_x) { monster->vx = -monster->vx; }
+	if (next_y < MONSTER_HABITAT_TOP || MAX_Y <= next_y) { monster->vy = -monster->vy; }
+
+	return *target != -1;
+}
+
+/* Closest approach over the turn of a drone going from a to b and the monster ending at (x, y). */
+static bool hits(struct vec2d a, struct vec2d b, const struct lure_monster *monster) {
+	long rx = (monster->x - monster->vx) - a.x;
+	long ry = (monster->y - monster->vy) - a.y;
+	long vx = monster->vx - (b.x - a.x);
+	long vy = monster->vy - (b.y - a.y);
+	long v2 = (vx * vx) + (vy * vy);
+	long dot = (rx * vx) + (ry * vy);
+	long limit = (long)MONSTER_COLLISION_DISTANCE * MONSTER_COLLISION_DISTANCE;
+
+	if (0 <= dot || !v2) { return (rx * rx) + (ry * ry) <= limit; }
+	if (v2 <= -dot) { return dist2(rx + vx, ry + vy, 0, 0) <= limit; }
+	return ((rx * rx) + (ry * ry)) - ((dot * dot) / v2) <= limit;
+}
+
+int lure_value(const struct lure_setup *setup, const struct drone *drone, struct vec2d vector, bool light) {
+	struct vec2d me = { MAX(0, MIN(MAX_X - 1, drone->x + vector.x)), MAX(0, MIN(MAX_Y - 1, drone->y + vector.y)) };
+	bool hit[PLAYER_DRONE_COUNT] = {};
+	int value = 0;
+
+	for (int m = 0; m < setup->monster_count; m++) {
+		struct lure_monster monster = setup->monsters[m];
+		bool lured = false;
+
+		/* NOTE(benjamin): This turn the monster moves on its current speed, the manoeuvre only shows when it retargets. */
+		monster.x = MAX(0, MIN(MAX_X - 1, monster.x + monster.vx));
+		monster.y = MAX(MONSTER_HABITAT_TOP, MIN(MAX_Y - 1, monster.y + monster.vy));
+
+		/* NOTE(benjamin): At the end of every turn the monster picks its chase, then moves on it during the next one. */
+		for (int turn = 1; turn <= LURE_TURNS; turn++) {
+			struct vec2d drones[2 + PLAYER_DRONE_COUNT] = { me, setup->partner };
+			int ranges[2 + PLAYER_DRONE_COUNT] = { (light && turn == 1) ? DRONE_LIGHT_SCAN_DISTANCE : DRONE_FISH_SCAN_DISTANCE, DRONE_FISH_SCAN_DISTANCE };
+			int count = 2;
+			for (int i = 0; i < setup->foe_count; i++) {
+				if (!setup->foe_alive[i] || hit[i]) { continue; }
+				drones[count] = setup->foe_path[turn][i];
+				ranges[count] = DRONE_FISH_SCAN_DISTANCE;
+				count += 1;
+			}
+
+			int target;
+			if (retarget(&monster, drones, ranges, count, &target) && target == 0) { lured = true; }
+
+			monster.x = MAX(0, MIN(MAX_X - 1, monster.x + monster.vx));
+			monster.y = MAX(MONSTER_HABITAT_TOP, MIN(MAX_Y - 1, monster.y + monster.vy));
+			if (!lured) { continue; }
+
+			for (int i = 0; i < setup->foe_count; i++) {
+				if (!setup->foe_alive[i] || hit[i]) { continue; }
+				if (!hits(setup->foe_path[turn][i], setup->foe_path[turn + 1][i], &monster)) { continue; }
+
+				hit[i] = true;
+				value += setup->foe_points[i];
+			}
+		}
+	}
+
+	return value;
+}
@@ -0,0 +1,48 @@
+/*
+ * Monster luring, drawing monsters onto foe drones that carry unsaved scans.
+ *
+ * A monster chases the closest drone within that drone's light distance, so
+ * one of our drones moving and lighting next to a monster sets the way the
+ * monster goes for the next turn. lure_value() plays a manoeuvre of ours for
+ * a few turns against the seen monsters and the foe forecast, our drone then
+ * holding still without light, and counts the scans the foe loses to the
+ * monsters our drone drew. Our drone outruns a chasing monster, getting away
+ * from it is left to the collision checks of the next turns.
+ *
+ * lure_begin() rolls the foe once per turn, a manoeuvre is then a few
+ * integer steps per seen monster, well within the per vector budget.
+ */
+#ifndef LURE_H
+#define LURE_H
+
+#include "engine.h"
+#include "fishsim.h"
+#include "foe.h"
+#include "movement.h"
+
+#define LURE_TURNS (3)
+
+struct lure_monster {
+	int x;
+	int y;
+	int vx;
+	int vy;
+};
+
+struct lure_setup {
+	int monster_count;
+	struct lure_monster monsters[MONSTER_COUNT_MAX];
+	int foe_count;
+	struct vec2d foe_path[LURE_TURNS + 2][PLAYER_DRONE_COUNT]; /* [t] at the end of turn t, [0] is now */
+	bool foe_alive[PLAYER_DRONE_COUNT];
+	int foe_points[PLAYER_DRONE_COUNT]; /* points of the scans the foe drone carries at the start */
+	struct vec2d partner; /* our other drone, left where it is */
+};
+
+/* Seen monsters and foe paths of the engine state, false when there is nothing to lure onto. */
+bool lure_begin(struct lure_setup *setup, const struct drone *drone, const struct foe_forecast *foe, const struct fish_school *school);
+
+/* Points the foe loses when drone plays vector then holds, light on the first turn. */
+int lure_value(const struct lure_setup *setup, const struct drone *drone, struct vec2d vector, bool light);
+
+#endif
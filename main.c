@@ -0,0 +1,42 @@
+/*
+ * Bot entry point, plays one strategy over stdin/stdout.
+ *
+ *     cc -O2 -o bot main.c engine.c strategies.c movement.c symmetry.c radar.c danger.c intmath.c surfacing.c endgame.c foe.c lure.c rhea.c eval.c record.c pool.c trace.c fishsim.c tt.c search.c mark*.c node-chaser_mk1.c -lm -pthread
+ *     ./bot [strategy] [trace file]
+ *
+ * The referee takes a single source file, amalgamate.sh bundles mark4 and
+ * everything it needs into one:
+ *
+ *     ./amalgamate.sh > bot.c && cc -O2 -o bot bot.c -lm
+ *
+ * The referee cannot pass arguments so mark4 is played by default. With a
+ * trace file the decisions are recorded for trace_dump.
+ */
+#include "engine.h"
+#include "trace.h"
+
+int main(int argc, char **argv)
+{
+	const struct strategy *strategy = find_strategy("mark4");
+
+	if (2 <= argc) {
+		strategy = find_strategy(argv[1]);
+		if (!strategy) {
+			fprintf(stderr, "unknown strategy: %s\navailable:", argv[1]);
+			for (int i = 0; strategies[i]; i++) {
+				fprintf(stderr, " %s", strategies[i]->name);
+			}
+			fprintf(stderr, "\n");
+			return 1;
+		}
+	}
+
+	if (3 <= argc) {
+		trace_open(argv[2]);
+	}
+
+	engine_run(strategy);
+	trace_close();
+
+	return 0;
+}
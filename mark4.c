@@ -3,285 +3,43 @@
  *
  * Selects the "best" direction for each drone from a fixed set of possible directions.
  */
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-#include <stdbool.h>
-#include <stdarg.h>
 #include <limits.h>
-#include <math.h>
 
-#define ARRLEN(x) (sizeof(x) / sizeof(*x))
-#define MIN(a,b) ((a) < (b) ? (a) : (b))
-#define MAX(a,b) ((a) > (b) ? (a) : (b))
-
-static void assert(bool cond, char *fmt, ...) {
-	if (!cond) {
-		va_list args;
-		va_start(args, fmt);
-		vfprintf(stderr, fmt, args);
-		va_end(args);
-		abort();
-	}
-}
-
-#if 1
-#define DEBUG_BUILD
-#endif
-
-static void dbg(char *fmt, ...) {
-	(void)fmt;
-#ifdef DEBUG_BUILD
-	va_list args;
-	va_start(args, fmt);
-	vfprintf(stderr, fmt, args);
-	va_end(args);
-#endif
-}
-
-struct vec2d {
-	int x;
-	int y;
-};
-
-#define MAX_X (10000)
-#define MAX_Y (10000)
-
-#define DRONE_BATTERY_MAX (30)
-
-#define DRONE_FISH_SCAN_DISTANCE (800)
-#define DRONE_TURN_MOVE_DISTANCE (600)
-#define DRONE_SCAN_SUBMIT_DEPTH (500)
-
-#define PLAYER_COUNT (2)
-#define PLAYER_DRONE_COUNT (2)
-#define TOTAL_DRONE_COUNT (PLAYER_DRONE_COUNT * PLAYER_COUNT)
-
-#define FISH_COLOR_COUNT (4)
-#define FISH_TYPE_COUNT (3)
-#define FISH_COUNT (FISH_COLOR_COUNT * FISH_TYPE_COUNT)
-
-#define MONSTER_COUNT_MAX (8) /* MIN is 1 */
-#define MONSTER_COLLISION_DISTANCE (500)
-
-/* 4 drones and 12 fish in Wood League 1. */
-#define MAX_ENTITIES (TOTAL_DRONE_COUNT + FISH_COUNT + MONSTER_COUNT_MAX)
+#include "danger.h"
+#include "endgame.h"
+#include "foe.h"
+#include "lure.h"
+#include "engine.h"
+#include "fishsim.h"
+#include "intmath.h"
+#include "movement.h"
+#include "mark4.h"
+#include "mark4_params.h"
+#include "opening.h"
+#include "pool.h"
+#include "radar.h"
+#include "record.h"
+#include "rhea.h"
+#include "search.h"
+#include "surfacing.h"
+#include "symmetry.h"
+#include "trace.h"
+#include "tt.h"
+#include "opening_book.h"
 
 #define COLLISION_POINTS_PER_VECTOR (10)
-#define NB_VECTOR_ANGLES (16)
-#define NB_VECTOR_SPEEDS (2)
-
-struct fish {
-	int color;    /* [0,3] */
-	int type;     /* [0,2] */
-	int x;        /* [0, 10000[ */
-	int y;        /* [0, 10000[ */
-	int vx;       /* [0, 10000[ ? */
-	int vy;       /* [0, 10000[ ? */
-	bool visible;
-	bool unavailable;
-};
+#define SEARCH_TT_BUCKET_BITS (14)
 
-enum direction {
-	BL,
-	TL,
-	BR,
-	TR,
-};
+struct mark4_params mark4_params = MARK4_PARAMS;
 
-struct radar_blip {
-	int creature_id;
-	enum direction direction;
-};
-
-enum drone_state {
-	EMERGENCY,
-	STARTING_ROUTE,
-	ROUTING_DOWN,
-	ROUTING_UP,
-	SURFACING,
-};
-
-struct drone {
-	int x;         /* [0, 10000] */
-	int y;         /* [0, 10000] */
-	int emergency; /* ??? */
-	int battery;   /* [0, 30] */
-	int blip_count;
-	struct radar_blip blips[FISH_COUNT + MONSTER_COUNT_MAX];
-	int scan_count;
-	int scans[FISH_COUNT];
-	enum drone_state state;
-	int turns_since_light;
-};
+int mark4_search_threads = 0;
+long mark4_rhea_generations = 0;
+long mark4_rhea_turns = 0;
 
-union entity {
-	struct fish fish;
-	struct drone drone;
-};
-
-struct player_state {
-	int score;
-	int scan_count;
-	/* 3 types, 4 colors */
-	int scans[FISH_COUNT];
-	int drone_count;
-	int drones[PLAYER_DRONE_COUNT];
-};
-
-struct state {
-	struct player_state my;
-	struct player_state foe;
-	int entity_count;
-	union entity entities[MAX_ENTITIES];
-};
-
-static struct state state;
-#define ENTITY_ID(ptr) ((union entity*)ptr - state.entities)
-
-static void submit_drone_move(int x, int y, int light, char *dbg, ...) {
-#ifndef DEBUG_BUILD
-	(void)dbg;
-	printf("MOVE %d %d %d\n", x, y, light);
-	return;
-#else
-	{
-		char buf[128];
-		va_list varargs;
-
-		va_start(varargs, dbg);
-		vsnprintf(buf, ARRLEN(buf), dbg, varargs);
-		va_end(varargs);
-
-		printf("MOVE %d %d %d %s\n", x, y, light, buf);
-	}
-	return;
-#endif
-}
-
-static void submit_drone_wait(int light, char *dbg, ...) {
-#ifdef DEBUG_BUILD
-	(void)dbg;
-	printf("WAIT %d\n", light);
-	return;
-#else
-	{
-		char buf[128];
-		va_list varargs;
-
-		va_start(varargs, dbg);
-		vsnprintf(buf, ARRLEN(buf), dbg, varargs);
-		va_end(varargs);
-
-		printf("WAIT %d %s\n", light, buf);
-	}
-	return;
-#endif
-}
-
-static void parse_round_input(void) {
-	scanf("%d", &state.my.score);
-	scanf("%d", &state.foe.score);
-	scanf("%d", &state.my.scan_count);
-	for (int i = 0; i < state.my.scan_count; i++) {
-		int creature_id;
-		scanf("%d", &creature_id);
-		state.my.scans[i] = creature_id;
-	}
-	scanf("%d", &state.foe.scan_count);
-	for (int i = 0; i < state.foe.scan_count; i++) {
-		int creature_id;
-		scanf("%d", &creature_id);
-		state.foe.scans[i] = creature_id;
-	}
-	scanf("%d", &state.my.drone_count);
-	for (int i = 0; i < state.my.drone_count; i++) {
-		int drone_id;
-		int drone_x;
-		int drone_y;
-		int emergency;
-		int battery;
-		scanf("%d%d%d%d%d", &drone_id, &drone_x, &drone_y, &emergency, &battery);
-
-		struct drone *drone = &state.entities[drone_id].drone;
-		state.my.drones[i] = drone_id;
-		drone->x = drone_x;
-		drone->y = drone_y;
-		drone->emergency = emergency;
-		drone->battery = battery;
-		drone->scan_count = 0;
-		drone->blip_count = 0;
-	}
-	scanf("%d", &state.foe.drone_count);
-	for (int i = 0; i < state.foe.drone_count; i++) {
-		int drone_id;
-		int drone_x;
-		int drone_y;
-		int emergency;
-		int battery;
-		scanf("%d%d%d%d%d", &drone_id, &drone_x, &drone_y, &emergency, &battery);
-
-		struct drone *drone = &state.entities[drone_id].drone;
-		state.foe.drones[i] = drone_id;
-		drone->x = drone_x;
-		drone->y = drone_y;
-		drone->emergency = emergency;
-		drone->battery = battery;
-		drone->scan_count = 0;
-		drone->blip_count = 0;
-		drone->turns_since_light += 1;
-	}
-	int drone_scan_count;
-	scanf("%d", &drone_scan_count);
-	for (int i = 0; i < drone_scan_count; i++) {
-		int drone_id;
-		int creature_id;
-		scanf("%d%d", &drone_id, &creature_id);
-
-		struct drone *drone = &state.entities[drone_id].drone;
-		drone->scans[drone->scan_count++] = creature_id;
-	}
-	int visible_creature_count;
-	scanf("%d", &visible_creature_count);
-	for (int i = 0; i < visible_creature_count; i++) {
-		int creature_id;
-		int creature_x;
-		int creature_y;
-		int creature_vx;
-		int creature_vy;
-		scanf("%d%d%d%d%d", &creature_id, &creature_x, &creature_y, &creature_vx, &creature_vy);
-
-		struct fish *fish = &state.entities[creature_id].fish;
-		fish->x = creature_x;
-		fish->y = creature_y;
-		fish->vx = creature_vx;
-		fish->vy = creature_vy;
-	}
-	int radar_blip_count;
-	scanf("%d", &radar_blip_count);
-	for (int i = 0; i < radar_blip_count; i++) {
-		int drone_id;
-		int creature_id;
-		char radar[3];
-		scanf("%d%d%s", &drone_id, &creature_id, radar);
-
-		struct drone *drone = &state.entities[drone_id].drone;
-		drone->blips[drone->blip_count].creature_id = creature_id;
-		if (radar[0] == 'B' && radar[1] == 'L') { drone->blips[drone->blip_count].direction = BL; }
-		else if (radar[0] == 'T' && radar[1] == 'L') { drone->blips[drone->blip_count].direction = TL; }
-		else if (radar[0] == 'B' && radar[1] == 'R') { drone->blips[drone->blip_count].direction = BR; }
-		else if (radar[0] == 'T' && radar[1] == 'R') { drone->blips[drone->blip_count].direction = TR; }
-		else { assert(false, "unkown direction: %s\n", radar); }
-		drone->blip_count += 1;
-	}
-}
-
-static int abs_dist(int ax, int ay, int bx, int by) {
-	int dx = ax - bx;
-	int dy = ay - by;
-
-	return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
-}
+/* NOTE(benjamin): Only entries of the running search are ever read back, sharing it between players is fine. */
+static struct thread_pool search_pool;
+static struct search_engine search_engine;
+static bool search_ready;
 
 static bool is_scanned(struct drone *drone, int fish_id) {
 	for (int i = 0; i < ARRLEN(state.my.scans); i++) {
@@ -295,79 +53,163 @@ static bool is_scanned(struct drone *drone, int fish_id) {
 	return false;
 }
 
-static int vec2d_distance(struct vec2d a, struct vec2d b) {
-	int x_diff = a.x - b.x;
-	int y_diff = a.y - b.y;
-
-	return sqrt((x_diff * x_diff) + (y_diff * y_diff));
+/* Position of the drone in state.my.drones. */
+static int drone_index(struct drone *drone) {
+	return (state.my.drones[0] == ENTITY_ID(drone)) ? 0 : 1;
 }
 
 #define MAX_FISH_VALUE (100000)
 
-static int compute_fish_value(struct fish *fish) {
-	int fish_id = ENTITY_ID(fish);
+/*
+ * Per-turn valuation of every fish, filled once by compute_fish_values() and
+ * then only patched by plan_fish_scan() when a planned scan changes the combo
+ * counts.
+ */
+struct fish_valuation {
+	int value;       /* final score used by play_drone(), [0, MAX_FISH_VALUE * fish_value_scale] */
+	bool available;  /* not known to have left the game, stays false once the radar lost it */
+	bool planned;    /* counted in the combo counts by plan_fish_scan() */
+};
 
-	int fish_value = fish->type + 1;
+struct valuation_counts {
+	int my_color[FISH_COLOR_COUNT];
+	int my_type[FISH_TYPE_COUNT];
+	int foe_color[FISH_COLOR_COUNT];
+	int foe_type[FISH_TYPE_COUNT];
+	int blip_color[FISH_COLOR_COUNT];
+	int blip_type[FISH_TYPE_COUNT];
+	bool foe_has[FISH_COUNT];
+};
 
-	int scanned_of_color = 0;
-	int scanned_of_type = 0;
-	for (int i = 0; i < state.my.scan_count; i++) {
-		struct fish *scanned_fish = &state.entities[state.my.scans[i]].fish;
-		if (scanned_fish->color == fish->color) { scanned_of_color += 1; }
-		if (scanned_fish->type == fish->type) { scanned_of_type += 1; }
-	}
+static struct fish_valuation fish_values[FISH_COUNT];
+static struct valuation_counts valuation_counts;
+/* NOTE(benjamin): Rebuilt by guess_fish_positions() before anything reads it, each player overwrites it in self play. */
+static struct danger_grid danger;
+/* NOTE(benjamin): Solved every turn once endgame_active(), each player overwrites it in self play. */
+static struct endgame_plan endgame;
+static bool endgame_on;
+/* NOTE(benjamin): Rebuilt every turn after surfacing_begin_turn(), each player overwrites it in self play. */
+static struct foe_forecast foe_forecast;
+
+/*
+ * NOTE(benjamin): Only set while mark4-rhea plans. The populations live across turns, so each side
+ * keeps its own for self play, told apart by the drone IDs.
+ */
+static bool rhea_mode;
+static struct rhea rhea_players[PLAYER_COUNT];
+static struct rhea_problem rhea_problem;
+
+/* NOTE(benjamin): Only set while mark4-eval plans, its searches score the leaves with eval_leaf(). */
+static bool eval_mode;
+
+static int rhea_side(void) {
+	return (state.my.drones[0] < state.foe.drones[0]) ? 0 : 1;
+}
+
+static void compute_fish_valuation(int fish_id) {
+	struct fish *fish = &state.entities[fish_id].fish;
+	struct fish_valuation *valuation = &fish_values[FISH_INDEX(fish_id)];
+	struct valuation_counts *counts = &valuation_counts;
+
+	int fish_value = fish->type + 1;
 
 	int color_value;
-	switch (scanned_of_color) {
+	switch (counts->my_color[fish->color]) {
 		case 0: color_value = 1; break;
 		case 1: color_value = 1; break;
 		case 2: color_value = 3; break;
+		default: color_value = 0; break;
 	}
 
 	int type_value;
-	switch (scanned_of_type) {
+	switch (counts->my_type[fish->type]) {
 		case 0: type_value = 1; break;
 		case 1: type_value = 1; break;
 		case 2: type_value = 2; break;
 		case 3: type_value = 4; break;
+		default: type_value = 0; break;
 	}
 
-	bool foe_has_fish = false;
-	int foe_color_count = 0;
-	int foe_type_count = 0;
+	if (!counts->foe_has[FISH_INDEX(fish_id)]) { fish_value *= 2; }
+	if (counts->foe_color[fish->color] < 3) { color_value *= 2; }
+	if (counts->foe_type[fish->type] < 4) { type_value *= 2; }
 
-	for (int i = 0; i < state.foe.scan_count; i++) {
-		if (state.foe.scans[i] == fish_id) { foe_has_fish = true; }
+	if (counts->blip_color[fish->color] < mark4_params.color_blips_min) { color_value = 0; }
+	if (counts->blip_type[fish->type] < mark4_params.type_blips_min) { type_value = 0; }
+
+	fish_value += color_value + type_value;
+
+	assert(fish_value <= MAX_FISH_VALUE, "fish value too high!\n");
+	valuation->value = fish_value * mark4_params.fish_value_scale;
+}
+
+/* Runs once per turn, after guess_fish_positions(). */
+static void compute_fish_values(void) {
+	struct valuation_counts *counts = &valuation_counts;
+	memset(counts, 0, sizeof(*counts));
+
+	for (int i = 0; i < state.my.scan_count; i++) {
 		struct fish *scanned_fish = &state.entities[state.my.scans[i]].fish;
-		if (scanned_fish->color == fish->color) { foe_color_count += 1; }
-		if (scanned_fish->type == fish->type) { foe_type_count += 1; }
+		counts->my_color[scanned_fish->color] += 1;
+		counts->my_type[scanned_fish->type] += 1;
 	}
 
-	if (!foe_has_fish) { fish_value *= 2; }
-	if (foe_color_count < 3) { color_value *= 2; }
-	if (foe_type_count < 4) { type_value *= 2; }
-
-	int color_blip_count = 0;
-	int type_blip_count = 0;
+	for (int i = 0; i < state.foe.scan_count; i++) {
+		struct fish *scanned_fish = &state.entities[state.foe.scans[i]].fish;
+		counts->foe_has[FISH_INDEX(state.foe.scans[i])] = true;
+		counts->foe_color[scanned_fish->color] += 1;
+		counts->foe_type[scanned_fish->type] += 1;
+	}
 
 	struct drone *drone = &state.entities[state.my.drones[0]].drone;
 
 	for (int i = 0; i < drone->blip_count; i++) {
 		struct fish *radar_fish = &state.entities[drone->blips[i].creature_id].fish;
-		if (radar_fish->color == fish->color) { color_blip_count += 1; }
-		if (radar_fish->type == fish->type) { type_blip_count += 1; }
+		if (radar_fish->type == -1) { continue; }
+		counts->blip_color[radar_fish->color] += 1;
+		counts->blip_type[radar_fish->type] += 1;
 	}
 
-	if (color_blip_count < 3) { color_value = 0; }
-	if (type_blip_count < 4) { type_value = 0; }
+	for (int fish_id = TOTAL_DRONE_COUNT; fish_id < state.entity_count; fish_id++) {
+		struct fish *fish = &state.entities[fish_id].fish;
+		if (fish->type == -1) { continue; }
 
-	fish_value += color_value + type_value;
+		fish_values[FISH_INDEX(fish_id)].available = !fish->unavailable;
+		fish_values[FISH_INDEX(fish_id)].planned = false;
+		compute_fish_valuation(fish_id);
+	}
+}
 
-	assert(fish_value <= MAX_FISH_VALUE, "fish value too high!\n");
-	return fish_value * 100;
+/*
+ * Counts fish_id in the combo counts as if it was already scanned (or removes
+ * it again when planned is false) and only revalues the fish sharing its color
+ * or type.
+ */
+static void plan_fish_scan(int fish_id, bool planned) {
+	struct fish *fish = &state.entities[fish_id].fish;
+	struct fish_valuation *valuation = &fish_values[FISH_INDEX(fish_id)];
+	if (valuation->planned == planned) { return; }
+
+	int delta = planned ? 1 : -1;
+	valuation->planned = planned;
+	valuation_counts.my_color[fish->color] += delta;
+	valuation_counts.my_type[fish->type] += delta;
+
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *other = &state.entities[id].fish;
+		if (other->type == -1) { continue; }
+		if (other->color != fish->color && other->type != fish->type) { continue; }
+		compute_fish_valuation(id);
+	}
 }
 
 static bool monster_collision(struct drone *drone, struct vec2d vector) {
+	bool flagged = false;
+	for (int i = 0; i < COLLISION_POINTS_PER_VECTOR && !flagged; i++) {
+		flagged = danger_at(&danger, drone->x + ((vector.x * i) / COLLISION_POINTS_PER_VECTOR), drone->y + ((vector.y * i) / COLLISION_POINTS_PER_VECTOR), 1);
+	}
+	if (!flagged) { return false; }
+
 	for (int i = 0; i < COLLISION_POINTS_PER_VECTOR; i++) {
 		struct vec2d drone_snapshot = {
 			drone->x + ((vector.x * i) / COLLISION_POINTS_PER_VECTOR),
@@ -383,7 +225,7 @@ static bool monster_collision(struct drone *drone, struct vec2d vector) {
 				fish->y + ((fish->vy * i) / COLLISION_POINTS_PER_VECTOR),
 			};
 
-			if (vec2d_distance(drone_snapshot, monster_snapshot) <= MONSTER_COLLISION_DISTANCE) {
+			if (within(drone_snapshot.x, drone_snapshot.y, monster_snapshot.x, monster_snapshot.y, MONSTER_COLLISION_DISTANCE)) {
 				return true;
 			}
 		}
@@ -404,7 +246,7 @@ static bool fish_will_scan(struct drone *drone, struct vec2d drone_vec, struct f
 			fish->y + ((fish->vy / COLLISION_POINTS_PER_VECTOR) * i),
 		};
 
-		if (vec2d_distance(drone_snapshot, fish_snapshot) <= DRONE_FISH_SCAN_DISTANCE) {
+		if (within(drone_snapshot.x, drone_snapshot.y, fish_snapshot.x, fish_snapshot.y, DRONE_FISH_SCAN_DISTANCE)) {
 			return true;
 		}
 	}
@@ -413,58 +255,375 @@ static bool fish_will_scan(struct drone *drone, struct vec2d drone_vec, struct f
 }
 
 static int compute_weighted_value(struct vec2d drone_pos, struct vec2d drone_vector, int fish_value, struct vec2d fish_pos) {
-	int initial_distance = vec2d_distance(drone_pos, fish_pos);
-	drone_vector.x += drone_pos.x;
-	drone_vector.y += drone_pos.y;
-	int final_distance = vec2d_distance(drone_vector, fish_pos);
+	int initial_distance = int_distance(drone_pos.x, drone_pos.y, fish_pos.x, fish_pos.y);
+	int final_distance = int_distance(drone_pos.x + drone_vector.x, drone_pos.y + drone_vector.y, fish_pos.x, fish_pos.y);
 
-	double factor = 1.0 - ((double)final_distance / (double)initial_distance);
-	int weighted_value = (double)fish_value * factor;
-
-	return weighted_value;
+	return progress_value(fish_value, initial_distance, final_distance);
 }
 
-static struct vec2d movement_vectors[NB_VECTOR_ANGLES * NB_VECTOR_SPEEDS];
+/* A fish play_drone() heads for, with the parts that do not depend on the vector. */
+struct fish_target {
+	struct fish *fish;
+	struct vec2d position; /* next turn */
+	int value;
+	int distance; /* from the drone to position */
+	int speed;    /* rounded up */
+};
+
+static int fish_score(struct drone *drone, const struct fish_target *targets, int target_count, struct vec2d vector) {
+	int score = 0;
 
-static void compute_movement_vectors(void) {
-	for (int speed_i = 0; speed_i < NB_VECTOR_SPEEDS; speed_i++) {
-		float speed = ceil((DRONE_TURN_MOVE_DISTANCE * (NB_VECTOR_SPEEDS - speed_i)) / (float)NB_VECTOR_SPEEDS);
+	for (int t = 0; t < target_count; t++) {
+		const struct fish_target *target = &targets[t];
 
-		for (int rot_i = 0; rot_i < NB_VECTOR_ANGLES; rot_i++) {
-			int vector_index = (speed_i * NB_VECTOR_ANGLES) + rot_i;
-			float angle_rad = ((2 * rot_i) * M_PI) / NB_VECTOR_ANGLES;
-			float rot_vx = speed * cos(angle_rad);
-			float rot_vy = speed * sin(angle_rad);
+		if (fish_will_scan(drone, vector, target->fish)) {
+			score += target->value;
+		} else {
+			int final_distance = int_distance(drone->x + vector.x, drone->y + vector.y, target->position.x, target->position.y);
+			score += progress_value(target->value, target->distance, final_distance);
+		}
+	}
 
-			rot_vx = (rot_vx < 0) ? floorf(rot_vx) : ceilf(rot_vx);
-			rot_vy = (rot_vy < 0) ? floorf(rot_vy) : ceilf(rot_vy);
+	return score;
+}
+
+/*
+ * Upper bound of fish_score() for any vector as long as this one. The move
+ * samples stay within length of the drone and the fish samples within speed
+ * of its next position, so a fish further than both plus the scan distance
+ * cannot be scanned and the drone gets at most length closer to it.
+ */
+static int fish_score_bound(const struct fish_target *targets, int target_count, struct vec2d vector) {
+	int length = int_distance(0, 0, vector.x, vector.y) + 1;
+	int bound = 0;
 
-			dbg(
-				"vec#%d s:%f a:(%d/%d %fdeg %frad) v:{%f,%f}\n",
-				vector_index, speed, rot_i, NB_VECTOR_ANGLES,
-				(360.0 / (double)NB_VECTOR_ANGLES) * (double)rot_i, (double)angle_rad,
-				rot_vx, rot_vy
-			);
+	for (int t = 0; t < target_count; t++) {
+		const struct fish_target *target = &targets[t];
 
-			movement_vectors[vector_index].x = (int)rot_vx;
-			movement_vectors[vector_index].y = (int)rot_vy;
+		if (target->distance <= length + target->speed + DRONE_FISH_SCAN_DISTANCE) {
+			bound += target->value;
+		} else {
+			bound += (int)(((long)target->value * length) / target->distance);
 		}
 	}
 
-#if 0
-	{
-		char buf[256];
-		int buflen = snprintf(buf, ARRLEN(buf), "mov vecs:");
-		for (int i = 0; i < ARRLEN(movement_vectors); i++) {
-			buflen += snprintf(buf + buflen, ARRLEN(buf) - buflen, " {%d,%d}", movement_vectors[i].x, movement_vectors[i].y);
+	return bound;
+}
+
+static int vector_score(int fish_score, int scan_score, int drone_score, int explore_score) {
+	return ((fish_score * mark4_params.fish_weight) +
+			(scan_score * mark4_params.scan_weight) +
+			(drone_score * mark4_params.drone_weight) +
+			(explore_score * mark4_params.explore_weight)) / 100;
+}
+
+/*
+ * Share of the radar box of a hidden fish the next blip from (x, y) is
+ * expected to rule out. The blip cuts the box in four along x and y, with a
+ * uniform prior the expected remaining area is sum(quadrant^2) / area, which
+ * splits per axis. Fixed point, FIXED_ONE rules out the whole box.
+ */
+static int radar_information_gain(struct fish *fish, int x, int y) {
+	int width = fish->radar_right_x - fish->radar_left_x;
+	int height = fish->radar_bottom_y - fish->radar_top_y;
+	if (width <= 0 || height <= 0) { return 0; }
+
+	int left = MAX(0, MIN(width, x - fish->radar_left_x));
+	int top = MAX(0, MIN(height, y - fish->radar_top_y));
+
+	long kept_x = fixed_kept_share(left, width - left);
+	long kept_y = fixed_kept_share(top, height - top);
+
+	return FIXED_ONE - (int)((kept_x * kept_y) >> FIXED_SHIFT);
+}
+
+#define COLLISION_RESUME_BUDGET_US (5000)
+
+static bool collision_table_ready;
+
+/* NOTE(benjamin): A table the startup deadline cut short is finished a few milliseconds per turn, once the commands are out. */
+static void resume_collision_table(void) {
+	if (collision_table_ready) { return; }
+
+	startup_begin(COLLISION_RESUME_BUDGET_US);
+	collision_table_ready = search_collision_table_build();
+	dbg("collision table %s\n", collision_table_ready ? "complete" : "still partial");
+}
+
+#ifndef SINGLE_THREADED
+/*
+ * Pondering, only driven by engine_run(): while waiting for the next input the
+ * search runs on the predicted problem of every drone, the result is used
+ * as is when the real problem turns out close enough. The thread is spawned
+ * once by mark4_init() and sleeps on a condition variable between turns.
+ */
+struct ponder_slot {
+	bool predicted;
+	bool searched;
+	int turn; /* the prediction is for */
+	struct search_problem problem;
+	struct search_result result;
+};
+
+static struct ponder_slot ponder_slots[PLAYER_DRONE_COUNT];
+static atomic_bool ponder_stopping;
+static pthread_t ponder_thread;
+static bool ponder_ready; /* the thread is running */
+static pthread_mutex_t ponder_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ponder_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t ponder_done = PTHREAD_COND_INITIALIZER;
+static unsigned ponder_job; /* bumped by every mark4_ponder_start() */
+static bool pondering;
+
+static void *ponder_main(void *arg) {
+	(void)arg;
+	unsigned seen_job = 0;
+
+	pthread_mutex_lock(&ponder_lock);
+	for (;;) {
+		while (ponder_job == seen_job) {
+			pthread_cond_wait(&ponder_wake, &ponder_lock);
 		}
-		dbg("%s\n", buf);
+		seen_job = ponder_job;
+		pthread_mutex_unlock(&ponder_lock);
+
+		for (int i = 0; i < PLAYER_DRONE_COUNT; i++) {
+			struct ponder_slot *slot = &ponder_slots[i];
+			if (!slot->predicted) { continue; }
+
+			search_drone(&search_engine, &slot->problem, &slot->result);
+			slot->searched = !slot->result.stopped;
+		}
+
+		pthread_mutex_lock(&ponder_lock);
+		pondering = false;
+		pthread_cond_signal(&ponder_done);
 	}
+
+	return NULL;
+}
+
+static void mark4_ponder_start(void) {
+	resume_collision_table();
+	if (!ponder_ready) { return; }
+
+	atomic_store(&ponder_stopping, false);
+	pthread_mutex_lock(&ponder_lock);
+	pondering = true;
+	ponder_job += 1;
+	pthread_cond_signal(&ponder_wake);
+	pthread_mutex_unlock(&ponder_lock);
+}
+
+static void mark4_ponder_stop(void) {
+	atomic_store(&ponder_stopping, true);
+	pthread_mutex_lock(&ponder_lock);
+	while (pondering) {
+		pthread_cond_wait(&ponder_done, &ponder_lock);
+	}
+	pthread_mutex_unlock(&ponder_lock);
+}
+
+/* Pondered result for problem if the prediction held, drops the slot either way. */
+static bool take_pondered(struct drone *drone, const struct search_problem *problem, struct search_result *result) {
+	struct ponder_slot *slot = &ponder_slots[drone_index(drone)];
+	bool holds = slot->predicted && slot->searched && slot->turn == state.turn && search_prediction_holds(&slot->problem, problem);
+
+	if (holds) { *result = slot->result; }
+	slot->predicted = false;
+	slot->searched = false;
+
+	return holds;
+}
+
+/* For the moves that never reach search_ahead(), so no prediction outlives its turn. */
+static void drop_pondered(struct drone *drone) {
+	struct ponder_slot *slot = &ponder_slots[drone_index(drone)];
+	slot->predicted = false;
+	slot->searched = false;
+}
+
+static void predict_next_problem(struct drone *drone, const struct search_problem *problem, int move, bool light) {
+	struct ponder_slot *slot = &ponder_slots[drone_index(drone)];
+
+	search_predict(problem, move, light, &slot->problem);
+	slot->problem.stop = &ponder_stopping;
+	slot->turn = state.turn + 1;
+	slot->predicted = true;
+}
+#else
+static void mark4_ponder_start(void) {
+	resume_collision_table();
+}
+
+static bool take_pondered(struct drone *drone, const struct search_problem *problem, struct search_result *result) {
+	(void)drone;
+	(void)problem;
+	(void)result;
+	return false;
+}
+
+static void drop_pondered(struct drone *drone) {
+	(void)drone;
+}
+
+static void predict_next_problem(struct drone *drone, const struct search_problem *problem, int move, bool light) {
+	(void)drone;
+	(void)problem;
+	(void)move;
+	(void)light;
+}
 #endif
+
+static const struct endgame_route *endgame_route(struct drone *drone) {
+	if (!endgame_on) { return NULL; }
+	return &endgame.routes[drone_index(drone)];
+}
+
+/* Heads for the route target with the safe vector getting closest to it. */
+static void play_endgame_route(struct drone *drone, const struct endgame_route *route, const struct vec2d *vectors, const int *vector_ids, int vector_count, int light) {
+	struct vec2d target = { drone->x, 0 };
+	if (route->move == ENDGAME_FETCH) {
+		struct fish *fish = &state.entities[route->target_id].fish;
+		target = (struct vec2d){ fish->x + fish->vx, fish->y + fish->vy };
+	}
+
+	int best = 0;
+	long best_dist2 = LONG_MAX;
+	for (int i = 0; i < vector_count; i++) {
+		long d2 = dist2(drone->x + vectors[i].x, drone->y + vectors[i].y, target.x, target.y);
+		if (d2 < best_dist2) {
+			best_dist2 = d2;
+			best = i;
+		}
+	}
+
+	int x = drone->x + vectors[best].x;
+	int y = drone->y + vectors[best].y;
+	trace_action(ENTITY_ID(drone), vector_ids[best], x, y, light);
+	submit_drone_move(x, y, light, (route->move == ENDGAME_FETCH) ? "endgame fetch" : "endgame rise");
+}
+
+/* Fish values seen from drone, monsters and fish paths up to problem->depth, the drone fields are left alone. */
+static void fill_search_world(struct search_problem *problem, struct drone *drone, struct drone *other_drone) {
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *fish = &state.entities[id].fish;
+		struct search_creature creature = { fish->x, fish->y, fish->vx, fish->vy, 0 };
+
+		if (fish->type == -1) {
+			/* NOTE(benjamin): Out of sight monsters are kept where they were last seen, their speed is stale. */
+			if (!fish->visible) {
+				creature.vx = 0;
+				creature.vy = 0;
+			}
+			if (problem->monster_count < ARRLEN(problem->monsters)) {
+				problem->monsters[problem->monster_count] = creature;
+				problem->monster_count += 1;
+			}
+			continue;
+		}
+
+		struct fish_valuation *valuation = &fish_values[FISH_INDEX(id)];
+		if (!valuation->available || valuation->planned || is_scanned(drone, id)) { continue; }
+
+		creature.value = valuation->value;
+		if (is_scanned(other_drone, id)) {
+			creature.value = (creature.value * mark4_params.shared_fish_percent) / 100;
+		}
+		problem->fish[FISH_INDEX(id)] = creature;
+	}
+
+	struct fish_school school;
+	struct fish_drones drones;
+	fish_school_from_state(&school);
+	fish_drones_from_state(&drones);
+	search_roll_fish(problem, &school, &drones, &foe_forecast);
+}
+
+/* Multi-turn lookahead over the fish this drone still has to scan. */
+static void search_ahead(struct drone *drone, struct drone *other_drone, struct search_problem *problem, struct search_result *result) {
+	*problem = (struct search_problem){
+		.drone_x = drone->x,
+		.drone_y = drone->y,
+		.battery = drone->battery,
+		.light_min_depth = mark4_params.light_min_depth,
+		.depth = MIN(mark4_params.search_depth, SEARCH_DEPTH_MAX),
+		.danger = &danger,
+		.learned_leaf = eval_mode,
+	};
+	fill_search_world(problem, drone, other_drone);
+
+	if (rhea_mode) {
+		rhea_root_values(&rhea_players[rhea_side()], &rhea_problem, drone_index(drone), result);
+		dbg("rhea D%ld: best move %d\n", ENTITY_ID(drone), result->best_move);
+		return;
+	}
+
+	if (take_pondered(drone, problem, result)) {
+		dbg("search D%ld: pondered\n", ENTITY_ID(drone));
+		return;
+	}
+
+	search_drone(&search_engine, problem, result);
+
+	struct tt_stats stats = search_engine_tt_stats(&search_engine);
+	dbg("search D%ld: %ld nodes, tt %ld/%ld hits\n", ENTITY_ID(drone), result->nodes, stats.hits, stats.probes);
+}
+
+/* Evolves the joint plan of both drones, search_ahead() then reads its root values. */
+static void evolve_plans(void) {
+	struct rhea *rhea = &rhea_players[rhea_side()];
+	struct drone *first = &state.entities[state.my.drones[0]].drone;
+	struct drone *second = &state.entities[state.my.drones[1]].drone;
+
+	rhea_problem = (struct rhea_problem){
+		.world = {
+			.light_min_depth = mark4_params.light_min_depth,
+			.depth = RHEA_HORIZON,
+			.danger = &danger,
+		},
+	};
+	fill_search_world(&rhea_problem.world, first, second);
+
+	for (int i = 0; i < PLAYER_DRONE_COUNT; i++) {
+		struct drone *drone = &state.entities[state.my.drones[i]].drone;
+		rhea_problem.drones[i] = (struct rhea_drone){ drone->x, drone->y, drone->battery, !drone->emergency };
+	}
+
+	rhea_shift(rhea);
+	rhea_evolve(rhea, &rhea_problem);
+	mark4_rhea_generations += rhea->generations;
+	mark4_rhea_turns += 1;
+	dbg("rhea: %d generations, best fitness %d\n", rhea->generations, rhea->population[0].fitness);
+}
+
+/*
+ * Foe points lost to the monsters this drone draws, per vector. The light is
+ * only asked for when it lures more than the move alone.
+ */
+static void score_lures(struct drone *drone, int light, const struct vec2d *vectors, int vector_count, int *scores, bool *lights) {
+	struct fish_school school;
+	struct lure_setup lure;
+	fish_school_from_state(&school);
+	if (!lure_begin(&lure, drone, &foe_forecast, &school)) { return; }
+
+	bool can_light = !light && DRONE_LIGHT_BATTERY_COST <= drone->battery;
+	for (int i = 0; i < vector_count; i++) {
+		int points = lure_value(&lure, drone, vectors[i], light);
+		if (can_light) {
+			int lit_points = lure_value(&lure, drone, vectors[i], true);
+			lights[i] = points < lit_points;
+			points = MAX(points, lit_points);
+		}
+
+		/* NOTE(benjamin): Half the weight of a fish, the foe may well not go where the forecast has it. */
+		scores[i] = (points * mark4_params.fish_value_scale * mark4_params.fish_weight) / 200;
+	}
 }
 
 static void play_drone(struct drone *drone) {
-	const int light = (drone->y > 2000 && (drone->battery == DRONE_BATTERY_MAX || 4 <= drone->turns_since_light));
+	int light = (drone->y > mark4_params.light_min_depth &&
+			(drone->battery == DRONE_BATTERY_MAX || mark4_params.light_cooldown <= drone->turns_since_light));
 	if (light) {
 		drone->turns_since_light = 0;
 	} else {
@@ -479,175 +638,422 @@ static void play_drone(struct drone *drone) {
 
 	int vector_count = 0;
 	struct vec2d vectors[ARRLEN(movement_vectors)];
+	int vector_ids[ARRLEN(movement_vectors)];
 	int vector_fish_scores[ARRLEN(movement_vectors)] = {};
 	int vector_scan_scores[ARRLEN(movement_vectors)] = {};
 	int vector_drone_scores[ARRLEN(movement_vectors)] = {};
+	int vector_explore_scores[ARRLEN(movement_vectors)] = {};
 
 	for (int i = 0; i < ARRLEN(movement_vectors); i++) {
 		if (!monster_collision(drone, movement_vectors[i])) {
 			vectors[vector_count] = movement_vectors[i];
+			vector_ids[vector_count] = i;
 			vector_count += 1;
 		}
 	}
 
 	if (!vector_count) {
+		drop_pondered(drone);
 		submit_drone_wait(light, "trapped!");
 		return;
 	}
 
+	const struct endgame_route *route = endgame_route(drone);
+	if (route && route->move != ENDGAME_HOLD) {
+		drop_pondered(drone);
+		play_endgame_route(drone, route, vectors, vector_ids, vector_count, light);
+		return;
+	}
+
+	int target_count = 0;
+	struct fish_target targets[FISH_COUNT];
+
 	for (int ent_id = TOTAL_DRONE_COUNT; ent_id < state.entity_count; ent_id++) {
 		struct fish *fish = &state.entities[ent_id].fish;
-		if (fish->type == -1 || fish->unavailable || is_scanned(drone, ent_id)) { continue; }
+		if (fish->type == -1) { continue; }
+
+		/* NOTE(benjamin): A fish the other drone scans this turn is left to it, chasing it as well keeps the drones together. */
+		struct fish_valuation *valuation = &fish_values[FISH_INDEX(ent_id)];
+		if (!valuation->available || valuation->planned || is_scanned(drone, ent_id)) { continue; }
 
-		int fish_value = compute_fish_value(fish);
+		int fish_value = valuation->value;
 
 		struct vec2d fish_pos = { fish->x + fish->vx, fish->y + fish->vy };
 
-		if (is_scanned(other_drone, ent_id) || vec2d_distance(other_drone_pos, fish_pos) < vec2d_distance(drone_pos, fish_pos)) {
-			fish_value /= 2;
+		if (is_scanned(other_drone, ent_id) || dist2(other_drone_pos.x, other_drone_pos.y, fish_pos.x, fish_pos.y) < dist2(drone_pos.x, drone_pos.y, fish_pos.x, fish_pos.y)) {
+			fish_value = (fish_value * mark4_params.shared_fish_percent) / 100;
 		}
 
+		targets[target_count] = (struct fish_target){
+			.fish = fish,
+			.position = fish_pos,
+			.value = fish_value,
+			.distance = int_distance(drone_pos.x, drone_pos.y, fish_pos.x, fish_pos.y),
+			.speed = int_distance(0, 0, fish->vx, fish->vy) + 1,
+		};
+		target_count += 1;
+
+		if (fish->visible) { continue; }
 		for (int i = 0; i < vector_count; i++) {
-			if (fish_will_scan(drone, vectors[i], fish)) {
-				vector_fish_scores[i] += fish_value;
-			} else {
-				vector_fish_scores[i] += compute_weighted_value(drone_pos, vectors[i], fish_value, fish_pos);
-			}
+			int gain = radar_information_gain(fish, drone_pos.x + vectors[i].x, drone_pos.y + vectors[i].y);
+			vector_explore_scores[i] += (int)(((long)fish_value * gain) / FIXED_ONE);
 		}
 	}
 
 	int drone_scans_value = 0;
 	for (int i = 0; i < drone->scan_count; i++) {
-		struct fish *fish = &state.entities[drone->scans[i]].fish;
-		drone_scans_value += compute_fish_value(fish);
+		drone_scans_value += fish_values[FISH_INDEX(drone->scans[i])].value;
 	}
 
+	struct surfacing_plan surfacing;
+	surfacing_plan_drone(drone, &surfacing);
+	dbg("surfacing D%ld: fetch %d first, %d vs %d points\n", ENTITY_ID(drone), surfacing.fetch_count, surfacing.fetch_first_value, surfacing.bank_now_value);
+
 	for (int i = 0; i < vector_count; i++) {
-		if (drone_pos.y <= DRONE_SCAN_SUBMIT_DEPTH) { continue; }
+		/* NOTE(benjamin): A holding drone gets its scans saved by the end of the game. */
+		if (drone_pos.y <= DRONE_SCAN_SUBMIT_DEPTH || !surfacing_should_bank(&surfacing) || route) { continue; }
 		int final_y = drone_pos.y + vectors[i].y;
 		if (final_y <= DRONE_SCAN_SUBMIT_DEPTH) { vector_scan_scores[i] += drone_scans_value; }
 
 		int initial_distance = drone_pos.y - DRONE_SCAN_SUBMIT_DEPTH;
 		int final_distance = final_y - DRONE_SCAN_SUBMIT_DEPTH;
 
-		double factor = 1.0 - ((double)final_distance / (double)initial_distance);
-		vector_scan_scores[i] += (int)((double)drone_scans_value * factor);
+		vector_scan_scores[i] += progress_value(drone_scans_value, initial_distance, final_distance);
 	}
 
 	for (int i = 0; i < vector_count; i++) {
-		vector_drone_scores[i] += compute_weighted_value(drone_pos, vectors[i], -1, other_drone_pos);
+		vector_drone_scores[i] += compute_weighted_value(drone_pos, vectors[i], -mark4_params.drone_repulsion, other_drone_pos);
 	}
 
-#if 0
-	{
-		char buf[512];
-		int buf_len;
+	struct search_problem problem;
+	struct search_result search;
+	if (mark4_params.search_depth) {
+		search_ahead(drone, other_drone, &problem, &search);
+	}
 
-		buf_len = snprintf(buf, ARRLEN(buf), "D%ld", ENTITY_ID(drone));
-		for (int i = 0; i < vector_count; i++) {
-			assert(buf_len < ARRLEN(buf), "buffer overflow line %d\n", __LINE__);
-			buf_len += snprintf(buf + buf_len, ARRLEN(buf) - buf_len, " {%d,%d}:[%d,%d,%d]%d",
-					vectors[i].x, vectors[i].y,
-					vector_fish_scores[i], vector_scan_scores[i], vector_drone_scores[i],
-					vector_fish_scores[i] + vector_scan_scores[i] + vector_drone_scores[i]
-			);
+	int lure_scores[ARRLEN(movement_vectors)] = {};
+	bool lure_lights[ARRLEN(movement_vectors)] = {};
+	if (!route) {
+		score_lures(drone, light, vectors, vector_count, lure_scores, lure_lights);
+	}
+
+	int search_scores[ARRLEN(movement_vectors)] = {};
+	int fish_bounds[ARRLEN(movement_vectors)];
+	int bounds[ARRLEN(movement_vectors)];
+	int order[ARRLEN(movement_vectors)];
+	for (int i = 0; i < vector_count; i++) {
+		if (mark4_params.search_depth && search.legal[vector_ids[i]]) {
+			search_scores[i] = (search.values[vector_ids[i]] * mark4_params.search_weight) / 100;
+		}
+
+		fish_bounds[i] = fish_score_bound(targets, target_count, vectors[i]);
+		bounds[i] = vector_score(fish_bounds[i], vector_scan_scores[i], vector_drone_scores[i], vector_explore_scores[i]) + search_scores[i] + lure_scores[i];
+
+		/* NOTE(benjamin): Best bound first, ties by index so the pick matches a plain scan of every vector. */
+		int j = i;
+		for (; 0 < j && bounds[order[j - 1]] < bounds[i]; j--) {
+			order[j] = order[j - 1];
 		}
-		dbg("%s\n", buf);
+		order[j] = i;
 	}
-#endif
 
-	int best_score = vector_fish_scores[0] + vector_scan_scores[0] + vector_drone_scores[0];
+	/*
+	 * Branch and bound on the fish scores, the only part that is costly per
+	 * vector. Vectors whose bound cannot beat the best score are never
+	 * evaluated, the trace gets their bound instead.
+	 */
+	int best_score = INT_MIN;
 	int best_vector = 0;
-	for (int i = 1; i < vector_count; i++) {
-		int score = vector_fish_scores[i] + vector_scan_scores[i] + vector_drone_scores[i];
-		if (best_score < score) {
+	int evaluated = 0;
+	for (int k = 0; k < vector_count; k++) {
+		int i = order[k];
+		if (bounds[i] < best_score || (bounds[i] == best_score && best_vector < i)) {
+			trace_vector(ENTITY_ID(drone), vector_ids[i], true, fish_bounds[i], vector_scan_scores[i], vector_drone_scores[i], vector_explore_scores[i], search_scores[i], bounds[i]);
+			continue;
+		}
+
+		vector_fish_scores[i] = fish_score(drone, targets, target_count, vectors[i]);
+		evaluated += 1;
+
+		int score = vector_score(vector_fish_scores[i], vector_scan_scores[i], vector_drone_scores[i], vector_explore_scores[i]);
+		score += search_scores[i] + lure_scores[i];
+
+		trace_vector(ENTITY_ID(drone), vector_ids[i], false, vector_fish_scores[i], vector_scan_scores[i], vector_drone_scores[i], vector_explore_scores[i], search_scores[i], score);
+		if (best_score < score || (best_score == score && i < best_vector)) {
 			best_score = score;
 			best_vector = i;
 		}
 	}
+	dbg("D%ld: %d/%d vectors evaluated\n", ENTITY_ID(drone), evaluated, vector_count);
 
 	dbg("best is {%d,%d}\n", vectors[best_vector].x, vectors[best_vector].y);
+	if (lure_lights[best_vector] && !light) {
+		dbg("D%ld: lighting to lure, %d\n", ENTITY_ID(drone), lure_scores[best_vector]);
+		light = 1;
+		drone->turns_since_light = 0;
+	}
+
+	/* Let the other drone value fish as if this move's scans were already done. */
+	for (int ent_id = TOTAL_DRONE_COUNT; ent_id < state.entity_count; ent_id++) {
+		struct fish *fish = &state.entities[ent_id].fish;
+		if (fish->type == -1 || !fish_values[FISH_INDEX(ent_id)].available || is_scanned(drone, ent_id)) { continue; }
+
+		if (fish_will_scan(drone, vectors[best_vector], fish)) {
+			plan_fish_scan(ent_id, true);
+		}
+	}
+
+	if (mark4_params.search_depth) {
+		if (record_active()) {
+			struct eval_features features;
+			eval_features(&problem, 0, problem.drone_x, problem.drone_y, problem.battery, problem.scans, &features);
+			record_position(ENTITY_ID(drone), state.turn, &features, vector_ids[best_vector], light);
+		}
+		if (!rhea_mode) { predict_next_problem(drone, &problem, vector_ids[best_vector], light); }
+	}
 
 	drone_pos.x += vectors[best_vector].x;
 	drone_pos.y += vectors[best_vector].y;
 
+	trace_action(ENTITY_ID(drone), vector_ids[best_vector], drone_pos.x, drone_pos.y, light);
 	submit_drone_move(drone_pos.x, drone_pos.y, light, "");
 }
 
-static void guess_fish_positions(void) {
-	struct drone *drone_a = &state.entities[state.my.drones[0]].drone;
-	struct drone *drone_b = &state.entities[state.my.drones[1]].drone;
-	assert(drone_a->blip_count == drone_b->blip_count, "blip count mismatch\n");
+/* A pair stops mirroring once any drone got close enough to scare one of the two fish. */
+static bool pair_disturbed(struct box box_a, struct box box_b) {
+	for (int drone_id = 0; drone_id < TOTAL_DRONE_COUNT; drone_id++) {
+		struct drone *drone = &state.entities[drone_id].drone;
+
+		if (box_dist2(box_a, drone->x, drone->y) <= FISH_FLEE_DISTANCE * FISH_FLEE_DISTANCE ||
+				box_dist2(box_b, drone->x, drone->y) <= FISH_FLEE_DISTANCE * FISH_FLEE_DISTANCE) {
+			return true;
+		}
+	}
 
+	return false;
+}
+
+/* Ties mirrored pairs together: a seen fish places its partner, two hidden ones share their boxes. */
+static void share_symmetric_constraints(struct box boxes[FISH_COUNT], bool hidden[FISH_COUNT]) {
 	for (int fish_id = TOTAL_DRONE_COUNT; fish_id < state.entity_count; fish_id++) {
 		struct fish *fish = &state.entities[fish_id].fish;
-		if (fish->type == -1 || fish->visible) { continue; }
+		int partner_id = symmetry_partner(fish_id);
+		if (fish->type == -1 || partner_id < fish_id) { continue; }
 
-		enum direction *dir_a = NULL;
-		enum direction *dir_b = NULL;
+		struct fish *partner = &state.entities[partner_id].fish;
+		if (fish->asymmetric || partner->asymmetric || fish->unavailable || partner->unavailable) { continue; }
 
-		for (int i = 0; i < drone_a->blip_count; i++) {
-			if (drone_a->blips[i].creature_id == fish_id) { dir_a = &drone_a->blips[i].direction; }
-			if (drone_b->blips[i].creature_id == fish_id) { dir_b = &drone_b->blips[i].direction; }
-		}
-		assert((!dir_a && !dir_b) || (dir_a && dir_b), "blip mismatch\n");
-		if (!dir_a) {
-			fish->unavailable = true;
+		struct box box_a = fish->visible ? (struct box){ fish->x, fish->x, fish->y, fish->y } : boxes[FISH_INDEX(fish_id)];
+		struct box box_b = partner->visible ? (struct box){ partner->x, partner->x, partner->y, partner->y } : boxes[FISH_INDEX(partner_id)];
+
+		struct box shared = box_a;
+		if (pair_disturbed(box_a, box_b) || !intersect_box(&shared, mirror_box(box_b))) {
+			fish->asymmetric = true;
+			partner->asymmetric = true;
 			continue;
 		}
 
-		int const top_hab_lim[] = { 2500, 5000, 7500 };
-		int const bot_hab_lim[] = { 5000, 7500, 10000 };
-		int left_x = 0;
-		int right_x = MAX_X;
-		int top_y = top_hab_lim[fish->type];
-		int bottom_y = bot_hab_lim[fish->type];
-
-		switch (*dir_a) {
-			case BL: right_x = MIN(right_x, drone_a->x); top_y    = MAX(top_y,    drone_a->y); break;
-			case TL: right_x = MIN(right_x, drone_a->x); bottom_y = MAX(bottom_y, drone_a->y); break;
-			case BR: left_x  = MIN(left_x,  drone_a->x); top_y    = MAX(top_y,    drone_a->y); break;
-			case TR: left_x  = MIN(left_x,  drone_a->x); bottom_y = MAX(bottom_y, drone_a->y); break;
+		if (fish->visible && !partner->visible) {
+			partner->x = MIRROR_X(fish->x);
+			partner->y = fish->y;
+			partner->vx = -fish->vx;
+			partner->vy = fish->vy;
+			partner->tracked = true;
+			hidden[FISH_INDEX(partner_id)] = false;
+		} else if (partner->visible && !fish->visible) {
+			fish->x = MIRROR_X(partner->x);
+			fish->y = partner->y;
+			fish->vx = -partner->vx;
+			fish->vy = partner->vy;
+			fish->tracked = true;
+			hidden[FISH_INDEX(fish_id)] = false;
+		} else if (!fish->visible && !partner->visible) {
+			boxes[FISH_INDEX(fish_id)] = shared;
+			boxes[FISH_INDEX(partner_id)] = mirror_box(shared);
 		}
+	}
+}
+
+static void guess_fish_positions(void) {
+	struct box boxes[FISH_COUNT];
+	bool hidden[FISH_COUNT];
+
+	/* NOTE(benjamin): Hidden fish still hold last turn's estimate, one step brings it to this turn. */
+	struct fish_school school;
+	struct fish_drones drones;
+	fish_school_from_state(&school);
+	fish_drones_from_state(&drones);
+	fish_school_step(&school, &drones);
+
+	for (int fish_id = TOTAL_DRONE_COUNT; fish_id < state.entity_count; fish_id++) {
+		struct fish *fish = &state.entities[fish_id].fish;
+		if (fish->type != -1 && fish->visible) { fish->tracked = true; }
+	}
+
+	radar_update_boxes(boxes, hidden);
+	share_symmetric_constraints(boxes, hidden);
+
+	for (int fish_id = TOTAL_DRONE_COUNT; fish_id < state.entity_count; fish_id++) {
+		struct fish *fish = &state.entities[fish_id].fish;
+		if (fish->type == -1 || !hidden[FISH_INDEX(fish_id)]) { continue; }
+
+		struct box *box = &boxes[FISH_INDEX(fish_id)];
+		int lane = FISH_INDEX(fish_id);
 
-		switch (*dir_b) {
-			case BL: right_x = MIN(right_x, drone_b->x); top_y    = MAX(top_y,    drone_b->y); break;
-			case TL: right_x = MIN(right_x, drone_b->x); bottom_y = MAX(bottom_y, drone_b->y); break;
-			case BR: left_x  = MIN(left_x,  drone_b->x); top_y    = MAX(top_y,    drone_b->y); break;
-			case TR: left_x  = MIN(left_x,  drone_b->x); bottom_y = MAX(bottom_y, drone_b->y); break;
+		if (!fish->tracked) {
+			fish->x = (box->left_x + box->right_x) / 2;
+			fish->y = (box->top_y + box->bottom_y) / 2;
+			fish->vx = 0;
+			fish->vy = 0;
+			continue;
 		}
 
-		fish->x = (left_x + right_x) / 2;
-		fish->y = (top_y + bottom_y) / 2;
-		fish->vx = 0;
-		fish->vy = 0;
+		/* The radar box is the truth, the simulated position only picks a point inside it. */
+		fish->x = MAX(box->left_x, MIN(box->right_x, (int)school.x[lane]));
+		fish->y = MAX(box->top_y, MIN(box->bottom_y, (int)school.y[lane]));
+		fish->vx = school.vx[lane];
+		fish->vy = school.vy[lane];
 	}
+
+	radar_store_boxes(boxes);
+
+	/*
+	 * NOTE(benjamin): Hidden monsters stay where they were last seen for the exact tests, moving them into
+	 * their radar box or dropping the stale ones both lost games. The boxes only add danger on the grid.
+	 */
+	radar_update_monster_boxes();
+	danger_build(&danger, DANGER_TURNS);
 }
 
-int main()
-{
-	int creature_count;
-	scanf("%d", &creature_count);
+static void mark4_init(void) {
+	compute_movement_vectors();
+	compute_symmetry_partners();
+	radar_init_boxes();
+	endgame_reset();
+	danger_init();
+	collision_table_ready = search_collision_table_build();
+	if (!collision_table_ready) { dbg("startup deadline hit, part of the collision table left to the exact test\n"); }
+#ifdef DEBUG_BUILD
+	intmath_check();
+	search_collision_check();
+	search_danger_check();
+#endif
 
-	state.entity_count = TOTAL_DRONE_COUNT + creature_count;
+	if (!search_ready) {
+		pool_init(&search_pool, mark4_search_threads);
+		search_engine_init(&search_engine, &search_pool, SEARCH_TT_BUCKET_BITS);
+#ifndef SINGLE_THREADED
+		ponder_ready = (pthread_create(&ponder_thread, NULL, ponder_main, NULL) == 0);
+#endif
+		search_ready = true;
+	}
+}
 
-	for (int i = 0; i < creature_count; i++) {
-		int id;
-		scanf("%d", &id);
+/* Book move for the drone this turn, false once the drone left the book. */
+static bool opening_move(struct drone *drone, struct vec2d *vector, int *light) {
+	if (drone->emergency) { drone->opening_step = OPENING_BOOK_TURNS; }
+	if (OPENING_BOOK_TURNS <= drone->opening_step) { return false; }
 
-		struct fish *fish = &state.entities[id].fish;
-		scanf("%d%d", &fish->color, &fish->type);
+	if (!drone->opening_step) { drone->opening_x = drone->x; }
+
+	int bucket = MIN(CANONICAL_X(drone->opening_x) / OPENING_BOOK_BUCKET_WIDTH, OPENING_BOOK_BUCKETS - 1);
+	unsigned char entry = opening_book[bucket][drone->opening_step];
+
+	*vector = movement_vectors[OPENING_ENTRY_VECTOR(entry)];
+	if (IS_MIRRORED_SIDE(drone->opening_x)) { vector->x = -vector->x; }
+	*light = OPENING_ENTRY_LIGHT(entry);
+
+	if (monster_collision(drone, *vector)) {
+		drone->opening_step = OPENING_BOOK_TURNS;
+		return false;
 	}
 
-	compute_movement_vectors();
+	return true;
+}
+
+static void mark4_plan_turn(void) {
+	struct drone *drones[PLAYER_DRONE_COUNT];
+	struct vec2d book_vectors[PLAYER_DRONE_COUNT];
+	if (!state.turn) { rhea_reset(&rhea_players[rhea_side()], 0x9e3779b97f4a7c15ULL); }
+
+	int book_lights[PLAYER_DRONE_COUNT];
+	bool on_book[PLAYER_DRONE_COUNT];
+	bool all_on_book = true;
+
+	/* NOTE(benjamin): The radar boxes need every turn and the book checks the danger grid. */
+	guess_fish_positions();
+	surfacing_begin_turn();
+	foe_from_state(&foe_forecast);
+
+	endgame_on = endgame_active();
+	if (endgame_on) {
+		endgame_solve(&endgame);
+		dbg("endgame: %+d points, %d/%d timelines memoized\n", endgame.delta, endgame.memo_hits, endgame.scored);
+	}
 
-	while (1) {
-		parse_round_input();
-		guess_fish_positions();
+	for (int i = 0; i < PLAYER_DRONE_COUNT; i++) {
+		drones[i] = &state.entities[state.my.drones[i]].drone;
+		on_book[i] = opening_move(drones[i], &book_vectors[i], &book_lights[i]);
+		all_on_book &= on_book[i];
+	}
 
-		play_drone(&state.entities[state.my.drones[0]].drone);
-		play_drone(&state.entities[state.my.drones[1]].drone);
+	/* NOTE(benjamin): Nothing to value while both drones are still diving on the book. */
+	if (!all_on_book) {
+		compute_fish_values();
+		if (rhea_mode && mark4_params.search_depth) { evolve_plans(); }
 	}
 
-	return 0;
+	for (int i = 0; i < PLAYER_DRONE_COUNT; i++) {
+		struct drone *drone = drones[i];
+
+		if (!on_book[i]) {
+			play_drone(drone);
+			continue;
+		}
+
+		drone->turns_since_light = book_lights[i] ? 0 : drone->turns_since_light + 1;
+		submit_drone_move(drone->x + book_vectors[i].x, drone->y + book_vectors[i].y, book_lights[i], "book %d", drone->opening_step);
+		drone->opening_step += 1;
+	}
 }
+
+const struct strategy mark4_strategy = {
+	.name = "mark4",
+	.init = mark4_init,
+	.plan_turn = mark4_plan_turn,
+	.ponder_start = mark4_ponder_start,
+#ifndef SINGLE_THREADED
+	.ponder_stop = mark4_ponder_stop,
+#endif
+};
+
+static void mark4_rhea_plan_turn(void) {
+	rhea_mode = true;
+	mark4_plan_turn();
+	rhea_mode = false;
+}
+
+/* Same bot with the rolling horizon evolution standing in for the tree search. */
+const struct strategy mark4_rhea_strategy = {
+	.name = "mark4-rhea",
+	.init = mark4_init,
+	.plan_turn = mark4_rhea_plan_turn,
+	.ponder_start = resume_collision_table,
+};
+
+static void mark4_eval_plan_turn(void) {
+	eval_mode = true;
+	mark4_plan_turn();
+	eval_mode = false;
+}
+
+/* Same bot with the learned leaf evaluation in its searches. */
+const struct strategy mark4_eval_strategy = {
+	.name = "mark4-eval",
+	.init = mark4_init,
+	.plan_turn = mark4_eval_plan_turn,
+	.ponder_start = mark4_ponder_start,
+#ifndef SINGLE_THREADED
+	.ponder_stop = mark4_ponder_stop,
+#endif
+};
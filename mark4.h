@@ -0,0 +1,35 @@
+/*
+ * mark4 tuning knobs, shared with the offline tools.
+ */
+#ifndef MARK4_H
+#define MARK4_H
+
+#include "engine.h"
+
+struct mark4_params {
+	int fish_value_scale;     /* multiplier applied to the fish values */
+	int shared_fish_percent;  /* fish value kept when the other drone is closer or has it */
+	int light_min_depth;      /* never light above this depth */
+	int light_cooldown;       /* turns between lights unless the battery is full */
+	int color_blips_min;      /* color combo is given up with fewer fish left on the radar */
+	int type_blips_min;       /* type combo is given up with fewer fish left on the radar */
+	int fish_weight;          /* percent, vector_fish_scores */
+	int scan_weight;          /* percent, vector_scan_scores */
+	int drone_weight;         /* percent, vector_drone_scores */
+	int drone_repulsion;      /* value of getting away from the other drone */
+	int explore_weight;       /* percent, vector_explore_scores */
+	int search_depth;         /* turns of lookahead, 0 disables the search */
+	int search_weight;        /* percent, search values */
+};
+
+extern struct mark4_params mark4_params;
+/* Search threads, read once by the first init, 0 uses every core. */
+extern int mark4_search_threads;
+/* Generations evolved and turns planned by mark4-rhea, summed over every game. */
+extern long mark4_rhea_generations;
+extern long mark4_rhea_turns;
+extern const struct strategy mark4_strategy;
+extern const struct strategy mark4_rhea_strategy;
+extern const struct strategy mark4_eval_strategy;
+
+#endif
@@ -0,0 +1,16 @@
+/* Generated by tune, hand edits are overwritten on the next run. */
+#define MARK4_PARAMS { \
+	.fish_value_scale = 100, \
+	.shared_fish_percent = 50, \
+	.light_min_depth = 2000, \
+	.light_cooldown = 4, \
+	.color_blips_min = 3, \
+	.type_blips_min = 4, \
+	.fish_weight = 100, \
+	.scan_weight = 100, \
+	.drone_weight = 100, \
+	.drone_repulsion = 1, \
+	.explore_weight = 25, \
+	.search_depth = 3, \
+	.search_weight = 100, \
+}
@@ -0,0 +1,48 @@
+#include "match.h"
+#include "record.h"
+#include "referee.h"
+
+/* NOTE(benjamin): Each player keeps its own copy of the engine state between turns. */
+static struct state views[PLAYER_COUNT];
+
+void play_match(const struct strategy *const players[PLAYER_COUNT], uint64_t seed, struct match_result *result) {
+	struct game game;
+	struct turn_commands commands;
+
+	game_init(&game, seed);
+	record_begin_game(seed);
+
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		memset(&state, 0, sizeof(state));
+		game_observe_init(&game);
+		players[p]->init();
+		views[p] = state;
+	}
+
+	while (!game.over) {
+		for (int p = 0; p < PLAYER_COUNT; p++) {
+			state = views[p];
+			game_observe(&game, p);
+			plan_turn(players[p], &commands);
+			views[p] = state;
+
+			game_submit(&game, p, &commands);
+		}
+
+		game_step(&game);
+	}
+
+	result->turns = game.turn;
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		result->scores[p] = game.players[p].score;
+	}
+	record_end_game(result->scores);
+
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		if (!players[p]->on_result) { continue; }
+
+		state = views[p];
+		players[p]->on_result(result->scores[p], result->scores[!p]);
+		views[p] = state;
+	}
+}
@@ -0,0 +1,19 @@
+/*
+ * Plays whole matches in-process: the referee and both strategies share the
+ * address space and exchange structs instead of text over pipes.
+ */
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+struct match_result {
+	int scores[PLAYER_COUNT];
+	int turns;
+};
+
+void play_match(const struct strategy *const players[PLAYER_COUNT], uint64_t seed, struct match_result *result);
+
+#endif
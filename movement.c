@@ -0,0 +1,42 @@
+#include <math.h>
+
+#include "movement.h"
+
+struct vec2d movement_vectors[MOVEMENT_VECTOR_COUNT];
+
+void compute_movement_vectors(void) {
+	for (int speed_i = 0; speed_i < NB_VECTOR_SPEEDS; speed_i++) {
+		float speed = ceil((DRONE_TURN_MOVE_DISTANCE * (NB_VECTOR_SPEEDS - speed_i)) / (float)NB_VECTOR_SPEEDS);
+
+		for (int rot_i = 0; rot_i < NB_VECTOR_ANGLES; rot_i++) {
+			int vector_index = (speed_i * NB_VECTOR_ANGLES) + rot_i;
+			float angle_rad = ((2 * rot_i) * M_PI) / NB_VECTOR_ANGLES;
+			float rot_vx = speed * cos(angle_rad);
+			float rot_vy = speed * sin(angle_rad);
+
+			rot_vx = (rot_vx < 0) ? floorf(rot_vx) : ceilf(rot_vx);
+			rot_vy = (rot_vy < 0) ? floorf(rot_vy) : ceilf(rot_vy);
+
+			dbg(
+				"vec#%d s:%f a:(%d/%d %fdeg %frad) v:{%f,%f}\n",
+				vector_index, speed, rot_i, NB_VECTOR_ANGLES,
+				(360.0 / (double)NB_VECTOR_ANGLES) * (double)rot_i, (double)angle_rad,
+				rot_vx, rot_vy
+			);
+
+			movement_vectors[vector_index].x = (int)rot_vx;
+			movement_vectors[vector_index].y = (int)rot_vy;
+		}
+	}
+
+#if 0
+	{
+		char buf[256];
+		int buflen = snprintf(buf, ARRLEN(buf), "mov vecs:");
+		for (int i = 0; i < ARRLEN(movement_vectors); i++) {
+			buflen += snprintf(buf + buflen, ARRLEN(buf) - buflen, " {%d,%d}", movement_vectors[i].x, movement_vectors[i].y);
+		}
+		dbg("%s\n", buf);
+	}
+#endif
+}
@@ -0,0 +1,22 @@
+/*
+ * Fixed set of drone movement vectors shared by mark4 and the offline tools.
+ */
+#ifndef MOVEMENT_H
+#define MOVEMENT_H
+
+#include "engine.h"
+
+#define NB_VECTOR_ANGLES (16)
+#define NB_VECTOR_SPEEDS (2)
+#define MOVEMENT_VECTOR_COUNT (NB_VECTOR_ANGLES * NB_VECTOR_SPEEDS)
+
+struct vec2d {
+	int x;
+	int y;
+};
+
+extern struct vec2d movement_vectors[MOVEMENT_VECTOR_COUNT];
+
+void compute_movement_vectors(void);
+
+#endif
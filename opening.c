@@ -0,0 +1,188 @@
+/*
+ * Offline opening book generator.
+ *
+ *     cc -O2 -o opening opening.c referee.c engine.c trace.c movement.c -lm -pthread
+ *     ./opening [layouts] [beam width] > opening_book.h
+ *
+ * The first turns of a match are the dive from the surface and depend mostly
+ * on where the drone starts. For every start bucket this runs a beam search
+ * over (movement vector, light) sequences, each scored by the referee over
+ * the same set of random creature layouts, and keeps the first turns of the
+ * sequence that scanned the most fish value on average without an emergency.
+ *
+ * Creatures are spawned mirrored around x=5000, so the book only covers the
+ * left half of the map and mark4 mirrors the moves for right-hand drones.
+ */
+#include "movement.h"
+#include "opening.h"
+#include "referee.h"
+
+#define OPENING_BOOK_TURNS (8)
+/* NOTE(benjamin): Searching past the book hides the greedy horizon moves of the last turns. */
+#define OPENING_SEARCH_TURNS (12)
+#define OPENING_BOOK_BUCKET_WIDTH (250)
+#define OPENING_BOOK_BUCKETS ((MAX_X / 2) / OPENING_BOOK_BUCKET_WIDTH)
+
+#define LAYOUT_MAX (64)
+#define BEAM_WIDTH_MAX (64)
+#define MOVE_COUNT (MOVEMENT_VECTOR_COUNT * 2)
+
+#define TESTED_DRONE GAME_DRONE_ID(0, 0)
+
+struct beam_node {
+	unsigned char moves[OPENING_SEARCH_TURNS];
+	double value;
+	struct game games[LAYOUT_MAX];
+};
+
+struct candidate {
+	int parent;
+	unsigned char move;
+	double value;
+};
+
+static int layout_count = 16;
+static int beam_width = 16;
+
+static struct beam_node beams[2][BEAM_WIDTH_MAX];
+static struct candidate candidates[BEAM_WIDTH_MAX * MOVE_COUNT];
+
+static void step_game(struct game *game, unsigned char move) {
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		struct turn_commands commands = { .count = PLAYER_DRONE_COUNT };
+
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			int drone_id = GAME_DRONE_ID(p, d);
+			struct drone_command *command = &commands.drones[d];
+
+			/* NOTE(benjamin): Everybody else holds still at the surface, out of the fish habitats. */
+			command->x = game->drones[drone_id].x;
+			command->y = game->drones[drone_id].y;
+
+			if (drone_id == TESTED_DRONE) {
+				command->x += movement_vectors[OPENING_ENTRY_VECTOR(move)].x;
+				command->y += movement_vectors[OPENING_ENTRY_VECTOR(move)].y;
+				command->light = OPENING_ENTRY_LIGHT(move);
+			}
+		}
+
+		game_submit(game, p, &commands);
+	}
+
+	game_step(game);
+}
+
+static double evaluate_game(const struct game *game) {
+	const struct game_drone *drone = &game->drones[TESTED_DRONE];
+	if (drone->emergency) { return -20.0; }
+
+	double value = 0;
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (drone->scans & (1u << i)) { value += game->creatures[i].type + 1; }
+	}
+
+	/* NOTE(benjamin): Depth only breaks ties, deeper is closer to the valuable fish. */
+	return value + ((double)drone->y / MAX_Y);
+}
+
+static double evaluate_move(const struct beam_node *parent, unsigned char move) {
+	double total = 0;
+
+	for (int l = 0; l < layout_count; l++) {
+		struct game game = parent->games[l];
+		step_game(&game, move);
+		total += evaluate_game(&game);
+	}
+
+	return total / layout_count;
+}
+
+static int compare_candidates(const void *a, const void *b) {
+	double va = ((const struct candidate *)a)->value;
+	double vb = ((const struct candidate *)b)->value;
+
+	return (va < vb) - (va > vb);
+}
+
+static void search_bucket(int bucket, unsigned char book[OPENING_BOOK_TURNS]) {
+	int start_x = (bucket * OPENING_BOOK_BUCKET_WIDTH) + (OPENING_BOOK_BUCKET_WIDTH / 2);
+	struct beam_node *beam = beams[0];
+	struct beam_node *next_beam = beams[1];
+	int beam_count = 1;
+
+	for (int l = 0; l < layout_count; l++) {
+		struct game *game = &beam[0].games[l];
+		game_init(game, 0x0b00c + l);
+		game->drones[TESTED_DRONE].x = start_x;
+	}
+
+	for (int turn = 0; turn < OPENING_SEARCH_TURNS; turn++) {
+		int candidate_count = 0;
+
+		for (int b = 0; b < beam_count; b++) {
+			for (int m = 0; m < MOVE_COUNT; m++) {
+				unsigned char move = OPENING_ENTRY(m % MOVEMENT_VECTOR_COUNT, m / MOVEMENT_VECTOR_COUNT);
+				struct candidate *candidate = &candidates[candidate_count++];
+
+				candidate->parent = b;
+				candidate->move = move;
+				candidate->value = evaluate_move(&beam[b], move);
+			}
+		}
+
+		qsort(candidates, candidate_count, sizeof(*candidates), compare_candidates);
+
+		int next_count = MIN(beam_width, candidate_count);
+		for (int c = 0; c < next_count; c++) {
+			const struct beam_node *parent = &beam[candidates[c].parent];
+			struct beam_node *node = &next_beam[c];
+
+			memcpy(node->moves, parent->moves, sizeof(node->moves));
+			node->moves[turn] = candidates[c].move;
+			node->value = candidates[c].value;
+
+			for (int l = 0; l < layout_count; l++) {
+				node->games[l] = parent->games[l];
+				step_game(&node->games[l], candidates[c].move);
+			}
+		}
+
+		struct beam_node *swap = beam;
+		beam = next_beam;
+		next_beam = swap;
+		beam_count = next_count;
+	}
+
+	memcpy(book, beam[0].moves, OPENING_BOOK_TURNS);
+	fprintf(stderr, "bucket %d (x=%d): %.2f\n", bucket, start_x, beam[0].value);
+}
+
+int main(int argc, char **argv)
+{
+	if (2 <= argc) { layout_count = MAX(1, MIN(LAYOUT_MAX, atoi(argv[1]))); }
+	if (3 <= argc) { beam_width = MAX(1, MIN(BEAM_WIDTH_MAX, atoi(argv[2]))); }
+
+	compute_movement_vectors();
+
+	printf("/* Generated by opening (%d layouts, beam width %d), do not edit. */\n", layout_count, beam_width);
+	printf("#define OPENING_BOOK_TURNS (%d)\n", OPENING_BOOK_TURNS);
+	printf("#define OPENING_BOOK_BUCKET_WIDTH (%d)\n", OPENING_BOOK_BUCKET_WIDTH);
+	printf("#define OPENING_BOOK_BUCKETS (%d)\n", OPENING_BOOK_BUCKETS);
+	printf("\n");
+	printf("static const unsigned char opening_book[OPENING_BOOK_BUCKETS][OPENING_BOOK_TURNS] = {\n");
+
+	for (int bucket = 0; bucket < OPENING_BOOK_BUCKETS; bucket++) {
+		unsigned char book[OPENING_BOOK_TURNS];
+		search_bucket(bucket, book);
+
+		printf("\t{");
+		for (int turn = 0; turn < OPENING_BOOK_TURNS; turn++) {
+			printf(" 0x%02x,", book[turn]);
+		}
+		printf(" },\n");
+	}
+
+	printf("};\n");
+
+	return 0;
+}
@@ -0,0 +1,16 @@
+/*
+ * Opening book entries, see opening.c for the generator.
+ *
+ * Books are indexed by the drone start x, mirrored to the left half of the
+ * map with CANONICAL_X(), and by turn. Each entry packs a movement_vectors index and the light.
+ */
+#ifndef OPENING_H
+#define OPENING_H
+
+#include "engine.h"
+
+#define OPENING_ENTRY(vector, light) ((unsigned char)((vector) | ((light) << 5)))
+#define OPENING_ENTRY_VECTOR(entry) ((entry) & 0x1f)
+#define OPENING_ENTRY_LIGHT(entry) (((entry) >> 5) & 1)
+
+#endif
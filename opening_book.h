@@ -0,0 +1,27 @@
+/* Generated by opening (16 layouts, beam width 16), do not edit. */
+#define OPENING_BOOK_TURNS (8)
+#define OPENING_BOOK_BUCKET_WIDTH (250)
+#define OPENING_BOOK_BUCKETS (20)
+
+static const unsigned char opening_book[OPENING_BOOK_BUCKETS][OPENING_BOOK_TURNS] = {
+	{ 0x03, 0x23, 0x23, 0x23, 0x22, 0x22, 0x24, 0x00, },
+	{ 0x03, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0e, },
+	{ 0x03, 0x23, 0x23, 0x23, 0x23, 0x22, 0x22, 0x12, },
+	{ 0x03, 0x23, 0x23, 0x23, 0x23, 0x23, 0x22, 0x00, },
+	{ 0x04, 0x23, 0x23, 0x23, 0x23, 0x23, 0x22, 0x10, },
+	{ 0x04, 0x23, 0x23, 0x24, 0x24, 0x23, 0x22, 0x00, },
+	{ 0x04, 0x24, 0x23, 0x24, 0x24, 0x23, 0x21, 0x01, },
+	{ 0x04, 0x24, 0x24, 0x23, 0x22, 0x23, 0x23, 0x0f, },
+	{ 0x04, 0x24, 0x24, 0x23, 0x23, 0x24, 0x24, 0x0e, },
+	{ 0x04, 0x24, 0x24, 0x24, 0x23, 0x24, 0x21, 0x00, },
+	{ 0x04, 0x24, 0x24, 0x25, 0x24, 0x23, 0x24, 0x0e, },
+	{ 0x04, 0x24, 0x25, 0x25, 0x24, 0x23, 0x22, 0x0f, },
+	{ 0x04, 0x25, 0x25, 0x24, 0x25, 0x25, 0x22, 0x00, },
+	{ 0x04, 0x24, 0x24, 0x24, 0x24, 0x26, 0x27, 0x08, },
+	{ 0x04, 0x24, 0x24, 0x25, 0x24, 0x26, 0x26, 0x09, },
+	{ 0x04, 0x24, 0x25, 0x25, 0x24, 0x24, 0x27, 0x18, },
+	{ 0x04, 0x24, 0x23, 0x23, 0x25, 0x23, 0x21, 0x04, },
+	{ 0x04, 0x24, 0x24, 0x24, 0x26, 0x26, 0x27, 0x07, },
+	{ 0x04, 0x24, 0x24, 0x23, 0x24, 0x24, 0x24, 0x10, },
+	{ 0x04, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0f, },
+};
@@ -0,0 +1,94 @@
+#include <unistd.h>
+
+#include "engine.h"
+#include "pool.h"
+
+static void run_tasks(struct thread_pool *pool, int worker) {
+	int task;
+	while ((task = atomic_fetch_add(&pool->next_task, 1)) < pool->task_count) {
+		pool->fn(pool->arg, task, worker);
+	}
+}
+
+#ifndef SINGLE_THREADED
+struct worker_start {
+	struct thread_pool *pool;
+	int worker;
+};
+
+static struct worker_start worker_starts[POOL_THREADS_MAX];
+
+static void *worker_main(void *arg) {
+	struct worker_start *start = arg;
+	struct thread_pool *pool = start->pool;
+	unsigned seen_job = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	for (;;) {
+		while (pool->job_id == seen_job) {
+			pthread_cond_wait(&pool->work_ready, &pool->lock);
+		}
+		seen_job = pool->job_id;
+		pthread_mutex_unlock(&pool->lock);
+
+		run_tasks(pool, start->worker);
+
+		pthread_mutex_lock(&pool->lock);
+		pool->busy -= 1;
+		if (!pool->busy) { pthread_cond_signal(&pool->work_done); }
+	}
+
+	return NULL;
+}
+#endif
+
+void pool_init(struct thread_pool *pool, int thread_count) {
+	if (thread_count <= 0) { thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN); }
+	thread_count = MAX(1, MIN(POOL_THREADS_MAX, thread_count));
+
+#ifdef SINGLE_THREADED
+	thread_count = 1;
+#else
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->work_ready, NULL);
+	pthread_cond_init(&pool->work_done, NULL);
+	pool->job_id = 0;
+	pool->busy = 0;
+
+	/* NOTE(benjamin): Worker starts are static, a process only ever has one pool. */
+	for (int i = 1; i < thread_count; i++) {
+		worker_starts[i] = (struct worker_start){ pool, i };
+		assert(pthread_create(&pool->threads[i], NULL, worker_main, &worker_starts[i]) == 0, "cannot spawn worker %d\n", i);
+	}
+#endif
+
+	pool->thread_count = thread_count;
+}
+
+void pool_run(struct thread_pool *pool, pool_task_fn fn, void *arg, int task_count) {
+	pool->fn = fn;
+	pool->arg = arg;
+	pool->task_count = task_count;
+	atomic_store(&pool->next_task, 0);
+
+	if (pool->thread_count == 1) {
+		run_tasks(pool, 0);
+		return;
+	}
+
+#ifndef SINGLE_THREADED
+	pthread_mutex_lock(&pool->lock);
+	pool->busy = pool->thread_count - 1;
+	pool->job_id += 1;
+	pthread_cond_broadcast(&pool->work_ready);
+	pthread_mutex_unlock(&pool->lock);
+
+	run_tasks(pool, 0);
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->busy) {
+		pthread_cond_wait(&pool->work_done, &pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+#endif
+}
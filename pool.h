@@ -0,0 +1,46 @@
+/*
+ * Fixed pool of worker threads for the searches.
+ *
+ * Threads are spawned once by pool_init() and sleep on a condition variable
+ * between jobs. pool_run() hands out task indices through an atomic counter,
+ * the calling thread works as worker 0 and returns once every task is done.
+ *
+ * Build with -DSINGLE_THREADED (no -pthread needed) to run every job inline,
+ * pool_init() also falls back to that when a single core is available.
+ */
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdatomic.h>
+
+#ifndef SINGLE_THREADED
+#include <pthread.h>
+#endif
+
+#define POOL_THREADS_MAX (16)
+
+typedef void (*pool_task_fn)(void *arg, int task, int worker);
+
+struct thread_pool {
+	int thread_count; /* including the calling thread */
+
+	pool_task_fn fn;
+	void *arg;
+	int task_count;
+	atomic_int next_task;
+
+#ifndef SINGLE_THREADED
+	pthread_t threads[POOL_THREADS_MAX];
+	pthread_mutex_t lock;
+	pthread_cond_t work_ready;
+	pthread_cond_t work_done;
+	unsigned job_id;
+	int busy;
+#endif
+};
+
+/* thread_count <= 0 uses every available core. */
+void pool_init(struct thread_pool *pool, int thread_count);
+void pool_run(struct thread_pool *pool, pool_task_fn fn, void *arg, int task_count);
+
+#endif
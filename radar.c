@@ -0,0 +1,143 @@
+#include "radar.h"
+
+static struct box habitat_box(const struct fish *fish) {
+	if (fish->type == -1) { return (struct box){ 0, MAX_X - 1, MONSTER_HABITAT_TOP, MAX_Y - 1 }; }
+	return (struct box){ 0, MAX_X - 1, FISH_HABITAT_TOP(fish->type), FISH_HABITAT_BOTTOM(fish->type) - 1 };
+}
+
+struct box radar_box(const struct fish *creature) {
+	return (struct box){ creature->radar_left_x, creature->radar_right_x, creature->radar_top_y, creature->radar_bottom_y };
+}
+
+static void store_box(struct fish *fish, struct box box) {
+	fish->radar_left_x = box.left_x;
+	fish->radar_right_x = box.right_x;
+	fish->radar_top_y = box.top_y;
+	fish->radar_bottom_y = box.bottom_y;
+}
+
+static void narrow_fish_box(struct box *box, struct drone *drone, enum direction direction) {
+	switch (direction) {
+		case BL: box->right_x = MIN(box->right_x, drone->x); box->top_y    = MAX(box->top_y,    drone->y); break;
+		case TL: box->right_x = MIN(box->right_x, drone->x); box->bottom_y = MIN(box->bottom_y, drone->y); break;
+		case BR: box->left_x  = MAX(box->left_x,  drone->x); box->top_y    = MAX(box->top_y,    drone->y); break;
+		case TR: box->left_x  = MAX(box->left_x,  drone->x); box->bottom_y = MIN(box->bottom_y, drone->y); break;
+		case NO_DIRECTION: break;
+	}
+}
+
+static bool box_empty(struct box box) {
+	return box.right_x < box.left_x || box.bottom_y < box.top_y;
+}
+
+/* NOTE(benjamin): Fish close enough to a drone may have fled at full speed since last turn. */
+static int max_fish_speed(struct box box) {
+	int scare_distance = FISH_FLEE_DISTANCE + DRONE_TURN_MOVE_DISTANCE;
+
+	for (int drone_id = 0; drone_id < TOTAL_DRONE_COUNT; drone_id++) {
+		struct drone *drone = &state.entities[drone_id].drone;
+		if (box_dist2(box, drone->x, drone->y) <= scare_distance * scare_distance) { return FISH_FLEE_SPEED; }
+	}
+
+	return FISH_SPEED;
+}
+
+static struct box widen_box(struct box box, int distance) {
+	return (struct box){ box.left_x - distance, box.right_x + distance, box.top_y - distance, box.bottom_y + distance };
+}
+
+/* Applies the blips of every drone of ours about fish_id, returns whether any drone saw it. */
+static bool narrow_with_blips(struct box *box, int fish_id) {
+	bool on_radar = false;
+
+	for (int i = 0; i < state.my.drone_count; i++) {
+		struct drone *drone = &state.entities[state.my.drones[i]].drone;
+
+		for (int j = 0; j < drone->blip_count; j++) {
+			if (drone->blips[j].creature_id != fish_id) { continue; }
+
+			narrow_fish_box(box, drone, drone->blips[j].direction);
+			on_radar = true;
+		}
+	}
+
+	return on_radar;
+}
+
+void radar_init_boxes(void) {
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *creature = &state.entities[id].fish;
+		store_box(creature, habitat_box(creature));
+	}
+}
+
+void radar_update_boxes(struct box boxes[FISH_COUNT], bool hidden[FISH_COUNT]) {
+	bool any_blip = false;
+	for (int i = 0; i < state.my.drone_count; i++) {
+		any_blip |= 0 < state.entities[state.my.drones[i]].drone.blip_count;
+	}
+
+	for (int fish_id = TOTAL_DRONE_COUNT; fish_id < state.entity_count; fish_id++) {
+		struct fish *fish = &state.entities[fish_id].fish;
+		if (fish->type == -1) { continue; }
+
+		struct box *box = &boxes[FISH_INDEX(fish_id)];
+		hidden[FISH_INDEX(fish_id)] = false;
+
+		if (fish->visible) {
+			*box = (struct box){ fish->x, fish->x, fish->y, fish->y };
+			continue;
+		}
+
+		struct box carried = radar_box(fish);
+		*box = widen_box(carried, max_fish_speed(carried));
+		intersect_box(box, habitat_box(fish));
+
+		bool on_radar = narrow_with_blips(box, fish_id);
+		if (any_blip && !on_radar) {
+			fish->unavailable = true;
+			continue;
+		}
+
+		/* NOTE(benjamin): Contradicting constraints mean the speed bound was wrong, start over from this turn. */
+		if (box_empty(*box)) {
+			*box = habitat_box(fish);
+			narrow_with_blips(box, fish_id);
+		}
+
+		hidden[FISH_INDEX(fish_id)] = true;
+	}
+}
+
+void radar_store_boxes(const struct box boxes[FISH_COUNT]) {
+	for (int fish_id = TOTAL_DRONE_COUNT; fish_id < state.entity_count; fish_id++) {
+		struct fish *fish = &state.entities[fish_id].fish;
+		if (fish->type == -1 || fish->unavailable) { continue; }
+
+		store_box(fish, boxes[FISH_INDEX(fish_id)]);
+	}
+}
+
+void radar_update_monster_boxes(void) {
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *monster = &state.entities[id].fish;
+		if (monster->type != -1) { continue; }
+
+		if (monster->visible) {
+			store_box(monster, (struct box){ monster->x, monster->x, monster->y, monster->y });
+			continue;
+		}
+
+		/* NOTE(benjamin): Chasing speed is the worst case, monsters never leave the game. */
+		struct box box = widen_box(radar_box(monster), MONSTER_CHASE_SPEED);
+		intersect_box(&box, habitat_box(monster));
+		narrow_with_blips(&box, id);
+
+		if (box_empty(box)) {
+			box = habitat_box(monster);
+			narrow_with_blips(&box, id);
+		}
+
+		store_box(monster, box);
+	}
+}
@@ -0,0 +1,34 @@
+/*
+ * Radar box tracking.
+ *
+ * Every blip says on which side of the drone the fish is, a half-plane on
+ * each axis. The box of a fish is the intersection of all the half-planes
+ * seen so far, each widened by the distance the fish could have swum since.
+ * Widening a box and intersecting commute for axis aligned constraints, so
+ * the history is carried as one box per fish: last turn's box grows by one
+ * turn of fish speed, then this turn's blips cut it down again.
+ */
+#ifndef RADAR_H
+#define RADAR_H
+
+#include "engine.h"
+#include "symmetry.h"
+
+/* Resets every creature box to its habitat, call once the creatures are known. */
+void radar_init_boxes(void);
+
+/*
+ * Carries last turn's boxes over and narrows them with the blips of every
+ * drone of ours. Visible fish get a single point box. Fish no longer on any
+ * radar are marked unavailable, hidden tells which fish need a guess.
+ */
+void radar_update_boxes(struct box boxes[FISH_COUNT], bool hidden[FISH_COUNT]);
+
+/* Keeps the boxes, possibly refined further, for the next turn. */
+void radar_store_boxes(const struct box boxes[FISH_COUNT]);
+
+/* Same carry over and narrowing for the monsters, their boxes only live in the state. */
+void radar_update_monster_boxes(void);
+struct box radar_box(const struct fish *creature);
+
+#endif
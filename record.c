@@ -0,0 +1,230 @@
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "record.h"
+
+#define POSITION_BYTES_MAX (1 + 5 + 1 + (EVAL_FEATURE_COUNT * 3))
+
+static int record_fd = -1;
+static bool in_game;
+static uint8_t chunk[sizeof(struct record_chunk_header) + (RECORD_POSITIONS_MAX * POSITION_BYTES_MAX) + 8];
+static size_t chunk_size;
+static uint32_t position_count;
+static int last_turn;
+static int16_t last_features[TOTAL_DRONE_COUNT][EVAL_FEATURE_COUNT];
+static uint64_t game_seed;
+
+static uint8_t *put_varint(uint8_t *out, uint32_t value) {
+	while (0x80 <= value) {
+		*out++ = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (uint8_t)value;
+	return out;
+}
+
+static const uint8_t *get_varint(const uint8_t *in, uint32_t *value) {
+	uint32_t result = 0;
+	int shift = 0;
+
+	while (*in & 0x80) {
+		result |= (uint32_t)(*in++ & 0x7f) << shift;
+		shift += 7;
+	}
+	*value = result | ((uint32_t)*in++ << shift);
+	return in;
+}
+
+static uint32_t zigzag(int32_t value) {
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+void record_open(const char *path) {
+	record_fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+	assert(record_fd != -1, "cannot open record file %s\n", path);
+}
+
+void record_close(void) {
+	if (record_fd == -1) { return; }
+
+	close(record_fd);
+	record_fd = -1;
+}
+
+bool record_active(void) {
+	return record_fd != -1;
+}
+
+void record_begin_game(uint64_t seed) {
+	in_game = record_active();
+	chunk_size = sizeof(struct record_chunk_header);
+	position_count = 0;
+	last_turn = 0;
+	game_seed = seed;
+	memset(last_features, 0, sizeof(last_features));
+}
+
+void record_position(int drone, int turn, const struct eval_features *features, int vector, bool light) {
+	if (!in_game) { return; }
+	assert(position_count < RECORD_POSITIONS_MAX, "more than %d positions in a game\n", RECORD_POSITIONS_MAX);
+	assert(last_turn <= turn, "record turn went back from %d to %d\n", last_turn, turn);
+
+	uint8_t *out = &chunk[chunk_size];
+	*out++ = (uint8_t)(drone | (light << 2));
+	out = put_varint(out, (uint32_t)(turn - last_turn));
+	*out++ = (uint8_t)vector;
+
+	for (int i = 0; i < EVAL_FEATURE_COUNT; i++) {
+		out = put_varint(out, zigzag(features->values[i] - last_features[drone][i]));
+		last_features[drone][i] = features->values[i];
+	}
+
+	chunk_size = out - chunk;
+	position_count += 1;
+	last_turn = turn;
+}
+
+void record_end_game(const int scores[PLAYER_COUNT]) {
+	if (!in_game) { return; }
+	in_game = false;
+
+	/* NOTE(benjamin): Chunks stay 8-byte aligned so the mapped headers can be read in place. */
+	while (chunk_size % 8) {
+		chunk[chunk_size++] = 0;
+	}
+
+	struct record_chunk_header header = {
+		.magic = RECORD_MAGIC,
+		.size = (uint32_t)(chunk_size - sizeof(header)),
+		.position_count = position_count,
+		.scores = { (int16_t)scores[0], (int16_t)scores[1] },
+		.seed = game_seed,
+	};
+	memcpy(chunk, &header, sizeof(header));
+
+	/* NOTE(benjamin): O_APPEND alone keeps whole writes together on a local disk, the lock covers the rest. */
+	assert(flock(record_fd, LOCK_EX) == 0, "cannot lock the record file\n");
+	ssize_t written = write(record_fd, chunk, chunk_size);
+	flock(record_fd, LOCK_UN);
+	assert(written == (ssize_t)chunk_size, "short record write, %zd of %zu bytes\n", written, chunk_size);
+}
+
+void record_map(const char *path, struct record_file *file) {
+	memset(file, 0, sizeof(*file));
+
+	int fd = open(path, O_RDONLY);
+	assert(fd != -1, "cannot open record file %s\n", path);
+
+	struct stat stat;
+	assert(fstat(fd, &stat) == 0, "cannot stat %s\n", path);
+	file->size = stat.st_size;
+	if (file->size) {
+		file->data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		assert(file->data != MAP_FAILED, "cannot map %s\n", path);
+	}
+	close(fd);
+
+	long capacity = 0;
+	long positions = 0;
+	size_t offset = 0;
+
+	while (offset + sizeof(struct record_chunk_header) <= file->size) {
+		const struct record_chunk_header *header = (const struct record_chunk_header *)(file->data + offset);
+		assert(header->magic == RECORD_MAGIC, "bad record chunk at byte %zu of %s\n", offset, path);
+		if (file->size < offset + sizeof(*header) + header->size) { break; }
+
+		if (file->chunk_count + 1 >= capacity) {
+			capacity = capacity ? 2 * capacity : 1024;
+			file->chunks = realloc(file->chunks, capacity * sizeof(*file->chunks));
+			file->first_position = realloc(file->first_position, capacity * sizeof(*file->first_position));
+			assert(file->chunks && file->first_position, "out of memory indexing %s\n", path);
+		}
+
+		file->chunks[file->chunk_count] = header;
+		file->first_position[file->chunk_count] = positions;
+		file->chunk_count += 1;
+		positions += header->position_count;
+		offset += sizeof(*header) + header->size;
+	}
+
+	if (!file->first_position) {
+		file->first_position = malloc(sizeof(*file->first_position));
+		assert(file->first_position, "out of memory indexing %s\n", path);
+	}
+	file->first_position[file->chunk_count] = positions;
+}
+
+void record_unmap(struct record_file *file) {
+	if (file->size) { munmap((void *)file->data, file->size); }
+	free(file->chunks);
+	free(file->first_position);
+	memset(file, 0, sizeof(*file));
+}
+
+/* Decodes the position at in, features are deltas against last[drone]. */
+static const uint8_t *decode(const uint8_t *in, int *turn, int16_t last[TOTAL_DRONE_COUNT][EVAL_FEATURE_COUNT], struct record_position *position) {
+	uint32_t value;
+
+	position->drone = *in & 3;
+	position->light = (*in >> 2) & 1;
+	in = get_varint(in + 1, &value);
+	*turn += (int)value;
+	position->turn = (int16_t)*turn;
+	position->vector = *in++;
+
+	memset(&position->features, 0, sizeof(position->features));
+	for (int i = 0; i < EVAL_FEATURE_COUNT; i++) {
+		in = get_varint(in, &value);
+		last[position->drone][i] = (int16_t)(last[position->drone][i] + unzigzag(value));
+		position->features.values[i] = last[position->drone][i];
+	}
+
+	return in;
+}
+
+int record_decode(const struct record_file *file, long index, struct record_position positions[RECORD_POSITIONS_MAX]) {
+	const struct record_chunk_header *header = file->chunks[index];
+	const uint8_t *in = (const uint8_t *)(header + 1);
+	int16_t last[TOTAL_DRONE_COUNT][EVAL_FEATURE_COUNT] = {};
+	int turn = 0;
+
+	int count = MIN((int)header->position_count, RECORD_POSITIONS_MAX);
+	for (int i = 0; i < count; i++) {
+		in = decode(in, &turn, last, &positions[i]);
+	}
+
+	return count;
+}
+
+void record_position_at(const struct record_file *file, long index, struct record_position *position, const struct record_chunk_header **chunk_header) {
+	assert(0 <= index && index < record_position_count(file), "record position %ld out of range\n", index);
+
+	long low = 0;
+	long high = file->chunk_count - 1;
+	while (low < high) {
+		long middle = (low + high + 1) / 2;
+		if (file->first_position[middle] <= index) {
+			low = middle;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	const struct record_chunk_header *header = file->chunks[low];
+	const uint8_t *in = (const uint8_t *)(header + 1);
+	int16_t last[TOTAL_DRONE_COUNT][EVAL_FEATURE_COUNT] = {};
+	int turn = 0;
+
+	for (long i = file->first_position[low]; i <= index; i++) {
+		in = decode(in, &turn, last, position);
+	}
+
+	if (chunk_header) { *chunk_header = header; }
+}
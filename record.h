@@ -0,0 +1,76 @@
+/*
+ * Self-play records, one chunk per game appended to a shared file.
+ *
+ * While a file is open, play_match() wraps every game in record_begin_game()
+ * and record_end_game() and the strategies call record_position() for every
+ * drone move they make. A position is the drone, the turn, the chosen vector
+ * and light, and the eval features of the drone before the move. The final
+ * scores are in the chunk header so every position knows how its game went.
+ *
+ * Chunk layout: struct record_chunk_header then size bytes of positions,
+ * each a byte of drone ID and light, a varint turn delta, a byte of vector
+ * and the features as zigzag varints, delta against the previous position
+ * of the same drone in the chunk, zero padded to 8 bytes. A game of 200
+ * turns is a few tens of kilobytes.
+ *
+ * A chunk goes out as a single write() on an O_APPEND descriptor under an
+ * exclusive flock(), so any number of runner processes can share a file.
+ * Readers mmap() the file and index the chunk headers, a torn chunk at the
+ * end of the file is skipped.
+ */
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <stdint.h>
+
+#include "eval.h"
+
+#define RECORD_MAGIC (0x31434552) /* "REC1" */
+#define RECORD_POSITIONS_MAX (GAME_TURN_MAX * TOTAL_DRONE_COUNT)
+
+struct record_chunk_header {
+	uint32_t magic;
+	uint32_t size; /* bytes of positions after the header */
+	uint32_t position_count;
+	int16_t scores[PLAYER_COUNT]; /* final, player of a drone is GAME_DRONE_PLAYER() of its ID */
+	uint64_t seed;
+};
+
+struct record_position {
+	uint8_t drone;
+	uint8_t vector;
+	bool light;
+	int16_t turn;
+	struct eval_features features;
+};
+
+/* Starts recording to path, recording stays off when never called. */
+void record_open(const char *path);
+void record_close(void);
+bool record_active(void);
+
+void record_begin_game(uint64_t seed);
+void record_position(int drone, int turn, const struct eval_features *features, int vector, bool light);
+void record_end_game(const int scores[PLAYER_COUNT]);
+
+struct record_file {
+	const uint8_t *data;
+	size_t size;
+	long chunk_count;
+	const struct record_chunk_header **chunks;
+	long *first_position; /* positions before every chunk, chunk_count + 1 entries */
+};
+
+void record_map(const char *path, struct record_file *file);
+void record_unmap(struct record_file *file);
+
+/* Decodes every position of a chunk, returns their count. */
+int record_decode(const struct record_file *file, long chunk, struct record_position positions[RECORD_POSITIONS_MAX]);
+/* Position index of the whole file, chunk found by bisection and decoded up to it. */
+void record_position_at(const struct record_file *file, long index, struct record_position *position, const struct record_chunk_header **chunk);
+
+static inline long record_position_count(const struct record_file *file) {
+	return file->first_position[file->chunk_count];
+}
+
+#endif
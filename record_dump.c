@@ -0,0 +1,78 @@
+/*
+ * Checks a self-play record file and times random access into it.
+ *
+ *     cc -O2 -o record_dump record_dump.c engine.c trace.c referee.c eval.c record.c -lm
+ *     ./record_dump <record file> [samples] [seed]
+ *
+ * Every chunk is decoded once to check it, then positions are drawn
+ * uniformly over the whole file the way a trainer would batch them.
+ */
+#include <time.h>
+
+#include "record.h"
+#include "referee.h"
+
+static double elapsed_s(const struct timespec *start) {
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) + ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <record file> [samples] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	long samples = (3 <= argc) ? atol(argv[2]) : 1000000;
+	uint64_t rng = (4 <= argc) ? strtoull(argv[3], NULL, 0) : 1;
+
+	struct record_file file;
+	record_map(argv[1], &file);
+
+	long positions = record_position_count(&file);
+	size_t used = file.chunk_count ? (size_t)((const uint8_t *)file.chunks[file.chunk_count - 1] - file.data) + sizeof(struct record_chunk_header) + file.chunks[file.chunk_count - 1]->size : 0;
+	printf("%ld games, %ld positions, %zu bytes", file.chunk_count, positions, file.size);
+	if (used < file.size) { printf(" (%zu torn at the end)", file.size - used); }
+	printf("\n");
+	if (!positions) { return 0; }
+
+	printf("%.1f bytes/position, %zu raw\n", (double)used / positions, sizeof(struct record_position));
+
+	static struct record_position decoded[RECORD_POSITIONS_MAX];
+	long score_sum[PLAYER_COUNT] = {};
+	long lights = 0;
+
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (long i = 0; i < file.chunk_count; i++) {
+		int count = record_decode(&file, i, decoded);
+		for (int j = 0; j < count; j++) {
+			lights += decoded[j].light;
+		}
+		for (int p = 0; p < PLAYER_COUNT; p++) {
+			score_sum[p] += file.chunks[i]->scores[p];
+		}
+	}
+	double decode_s = elapsed_s(&start);
+
+	printf("avg scores %.2f/%.2f, light on %.1f%% of the moves\n",
+			(double)score_sum[0] / file.chunk_count, (double)score_sum[1] / file.chunk_count, (100.0 * lights) / positions);
+	printf("sequential: %.1fM positions/s\n", positions / decode_s / 1e6);
+
+	long feature_sum = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (long i = 0; i < samples; i++) {
+		struct record_position position;
+		record_position_at(&file, (long)(rng_next(&rng) % (uint64_t)positions), &position, NULL);
+		feature_sum += position.features.values[EVAL_BEST_FISH];
+	}
+	double sample_s = elapsed_s(&start);
+
+	/* NOTE(benjamin): The sum only keeps the sampling loop from being optimized away. */
+	printf("random: %.1fM positions/minute (checksum %ld)\n", samples / sample_s * 60 / 1e6, feature_sum);
+
+	record_unmap(&file);
+	return 0;
+}
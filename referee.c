@@ -0,0 +1,505 @@
+#include <math.h>
+
+#include "referee.h"
+
+uint32_t rng_next(uint64_t *rng) {
+	/* NOTE(benjamin): xorshift64*, plenty for map generation and self-play. */
+	uint64_t x = *rng;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*rng = x;
+	return (x * 0x2545F4914F6CDD1DULL) >> 32;
+}
+
+int rng_range(uint64_t *rng, int min, int max) {
+	return min + (int)(rng_next(rng) % (uint32_t)(max - min));
+}
+
+static void creature_habitat(const struct game_creature *creature, int *top, int *bottom) {
+	if (creature->type == -1) {
+		*top = MONSTER_HABITAT_TOP;
+		*bottom = MAX_Y - 1;
+	} else {
+		*top = FISH_HABITAT_TOP(creature->type);
+		*bottom = FISH_HABITAT_BOTTOM(creature->type) - 1;
+	}
+}
+
+static void set_speed(int *vx, int *vy, double dx, double dy, int speed) {
+	double length = sqrt((dx * dx) + (dy * dy));
+	if (length == 0) {
+		*vx = 0;
+		*vy = 0;
+		return;
+	}
+
+	*vx = (int)round((dx / length) * speed);
+	*vy = (int)round((dy / length) * speed);
+}
+
+static int dist2(int ax, int ay, int bx, int by) {
+	int dx = ax - bx;
+	int dy = ay - by;
+
+	return (dx * dx) + (dy * dy);
+}
+
+static int drone_light_distance(const struct game_drone *drone) {
+	return drone->light ? DRONE_LIGHT_SCAN_DISTANCE : DRONE_FISH_SCAN_DISTANCE;
+}
+
+void game_init(struct game *game, uint64_t seed) {
+	memset(game, 0, sizeof(*game));
+	game->rng = seed ? seed : 1;
+
+	/* NOTE(benjamin): Creatures come in pairs mirrored around x=5000, the partner has color ^ 1. */
+	for (int type = 0; type < FISH_TYPE_COUNT; type++) {
+		for (int color = 0; color < FISH_COLOR_COUNT; color += 2) {
+			struct game_creature *fish = &game->creatures[game->creature_count];
+			struct game_creature *mirror = fish + 1;
+
+			fish->color = color;
+			fish->type = type;
+			fish->x = rng_range(&game->rng, 0, MAX_X / 2);
+			fish->y = rng_range(&game->rng, FISH_HABITAT_TOP(type), FISH_HABITAT_BOTTOM(type));
+			set_speed(&fish->vx, &fish->vy, rng_range(&game->rng, -100, 100), rng_range(&game->rng, -100, 100), FISH_SPEED);
+			fish->in_game = true;
+
+			*mirror = *fish;
+			mirror->color = color ^ 1;
+			mirror->x = (MAX_X - 1) - fish->x;
+			mirror->vx = -fish->vx;
+
+			game->creature_count += 2;
+		}
+	}
+
+	int monster_pairs = rng_range(&game->rng, 1, (MONSTER_COUNT_MAX / 2) + 1);
+	for (int i = 0; i < monster_pairs; i++) {
+		struct game_creature *monster = &game->creatures[game->creature_count];
+		struct game_creature *mirror = monster + 1;
+
+		monster->color = -1;
+		monster->type = -1;
+		monster->x = rng_range(&game->rng, 0, MAX_X / 2);
+		monster->y = rng_range(&game->rng, 5000, MAX_Y);
+		monster->in_game = true;
+
+		*mirror = *monster;
+		mirror->x = (MAX_X - 1) - monster->x;
+
+		game->creature_count += 2;
+	}
+
+	int start_x[PLAYER_COUNT] = { rng_range(&game->rng, 1000, 4000), 0 };
+	start_x[1] = 5000 - start_x[0] / 2;
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		struct game_drone *left = &game->drones[GAME_DRONE_ID(player, 0)];
+		struct game_drone *right = &game->drones[GAME_DRONE_ID(player, 1)];
+
+		left->x = start_x[player];
+		right->x = (MAX_X - 1) - start_x[player];
+		left->y = right->y = DRONE_SCAN_SUBMIT_DEPTH;
+		left->battery = right->battery = DRONE_BATTERY_MAX;
+	}
+}
+
+void game_observe_init(const struct game *game) {
+	state.entity_count = TOTAL_DRONE_COUNT + game->creature_count;
+
+	for (int i = 0; i < game->creature_count; i++) {
+		struct fish *fish = &state.entities[TOTAL_DRONE_COUNT + i].fish;
+		fish->color = game->creatures[i].color;
+		fish->type = game->creatures[i].type;
+	}
+}
+
+static void observe_player(const struct game *game, int player, struct player_state *out) {
+	const struct game_player *game_player = &game->players[player];
+
+	out->score = game_player->score;
+	out->scan_count = 0;
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (game_player->saved & (1u << i)) {
+			out->scans[out->scan_count++] = TOTAL_DRONE_COUNT + i;
+		}
+	}
+
+	out->drone_count = PLAYER_DRONE_COUNT;
+	for (int i = 0; i < PLAYER_DRONE_COUNT; i++) {
+		int drone_id = GAME_DRONE_ID(player, i);
+		const struct game_drone *game_drone = &game->drones[drone_id];
+		struct drone *drone = &state.entities[drone_id].drone;
+
+		out->drones[i] = drone_id;
+		drone->x = game_drone->x;
+		drone->y = game_drone->y;
+		drone->emergency = game_drone->emergency;
+		drone->battery = game_drone->battery;
+	}
+}
+
+void game_observe(const struct game *game, int player) {
+	begin_round_input();
+
+	state.turn = game->turn;
+	observe_player(game, player, &state.my);
+	observe_player(game, !player, &state.foe);
+
+	for (int drone_id = 0; drone_id < TOTAL_DRONE_COUNT; drone_id++) {
+		const struct game_drone *game_drone = &game->drones[drone_id];
+		struct drone *drone = &state.entities[drone_id].drone;
+
+		for (int i = 0; i < FISH_COUNT; i++) {
+			if (game_drone->scans & (1u << i)) {
+				drone->scans[drone->scan_count++] = TOTAL_DRONE_COUNT + i;
+			}
+		}
+	}
+
+	for (int i = 0; i < game->creature_count; i++) {
+		const struct game_creature *creature = &game->creatures[i];
+		if (!creature->in_game) { continue; }
+
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			const struct game_drone *game_drone = &game->drones[GAME_DRONE_ID(player, d)];
+			int distance = drone_light_distance(game_drone);
+
+			if (dist2(game_drone->x, game_drone->y, creature->x, creature->y) <= distance * distance) {
+				struct fish *fish = &state.entities[TOTAL_DRONE_COUNT + i].fish;
+				fish->x = creature->x;
+				fish->y = creature->y;
+				fish->vx = creature->vx;
+				fish->vy = creature->vy;
+				fish->visible = true;
+				break;
+			}
+		}
+
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			int drone_id = GAME_DRONE_ID(player, d);
+			const struct game_drone *game_drone = &game->drones[drone_id];
+			struct drone *drone = &state.entities[drone_id].drone;
+
+			drone->blips[drone->blip_count].creature_id = TOTAL_DRONE_COUNT + i;
+			drone->blips[drone->blip_count].direction = (creature->y < game_drone->y) | ((game_drone->x <= creature->x) << 1);
+			drone->blip_count += 1;
+		}
+	}
+}
+
+void game_submit(struct game *game, int player, const struct turn_commands *commands) {
+	assert(commands->count == PLAYER_DRONE_COUNT, "player %d submitted %d commands\n", player, commands->count);
+	game->players[player].commands = *commands;
+}
+
+static void move_drone(struct game_drone *drone, const struct drone_command *command) {
+	drone->light = false;
+
+	if (drone->emergency) {
+		drone->y = MAX(0, drone->y - DRONE_EMERGENCY_RISE_DISTANCE);
+		if (drone->y <= DRONE_SCAN_SUBMIT_DEPTH) { drone->emergency = false; }
+	} else if (command->wait) {
+		drone->y += DRONE_SINK_DISTANCE;
+	} else {
+		int dx = command->x - drone->x;
+		int dy = command->y - drone->y;
+		double length = sqrt(((double)dx * dx) + ((double)dy * dy));
+
+		if (length <= DRONE_TURN_MOVE_DISTANCE) {
+			drone->x = command->x;
+			drone->y = command->y;
+		} else {
+			drone->x += (int)((dx * DRONE_TURN_MOVE_DISTANCE) / length);
+			drone->y += (int)((dy * DRONE_TURN_MOVE_DISTANCE) / length);
+		}
+	}
+
+	drone->x = MAX(0, MIN(MAX_X - 1, drone->x));
+	drone->y = MAX(0, MIN(MAX_Y - 1, drone->y));
+
+	if (!drone->emergency && command->light && DRONE_LIGHT_BATTERY_COST <= drone->battery) {
+		drone->light = true;
+		drone->battery -= DRONE_LIGHT_BATTERY_COST;
+	} else {
+		drone->battery = MIN(DRONE_BATTERY_MAX, drone->battery + 1);
+	}
+}
+
+static void move_creature(struct game_creature *creature) {
+	creature->x += creature->vx;
+	creature->y += creature->vy;
+
+	if (creature->x < 0 || MAX_X <= creature->x) {
+		if (creature->fleeing) {
+			creature->in_game = false;
+			return;
+		}
+		creature->x = MAX(0, MIN(MAX_X - 1, creature->x));
+	}
+
+	int top;
+	int bottom;
+	creature_habitat(creature, &top, &bottom);
+	creature->y = MAX(top, MIN(bottom, creature->y));
+}
+
+/* Closest approach of a drone and a monster both moving in a straight line over the turn. */
+static bool drone_collides(int drone_x0, int drone_y0, const struct game_drone *drone, const struct game_creature *monster) {
+	double rx = (monster->x - monster->vx) - drone_x0;
+	double ry = (monster->y - monster->vy) - drone_y0;
+	double vx = monster->vx - (drone->x - drone_x0);
+	double vy = monster->vy - (drone->y - drone_y0);
+
+	double t = 0;
+	double v2 = (vx * vx) + (vy * vy);
+	if (v2 > 0) {
+		t = -((rx * vx) + (ry * vy)) / v2;
+		t = MAX(0, MIN(1, t));
+	}
+
+	double cx = rx + (vx * t);
+	double cy = ry + (vy * t);
+
+	return (cx * cx) + (cy * cy) <= (double)MONSTER_COLLISION_DISTANCE * MONSTER_COLLISION_DISTANCE;
+}
+
+static void update_fish_speed(struct game *game, struct game_creature *fish) {
+	double flee_x = 0;
+	double flee_y = 0;
+	bool flee = false;
+
+	for (int d = 0; d < TOTAL_DRONE_COUNT; d++) {
+		struct game_drone *drone = &game->drones[d];
+		if (drone->emergency) { continue; }
+
+		if (dist2(fish->x, fish->y, drone->x, drone->y) <= FISH_FLEE_DISTANCE * FISH_FLEE_DISTANCE) {
+			flee_x += fish->x - drone->x;
+			flee_y += fish->y - drone->y;
+			flee = true;
+		}
+	}
+
+	fish->fleeing = flee;
+
+	if (flee) {
+		set_speed(&fish->vx, &fish->vy, flee_x, flee_y, FISH_FLEE_SPEED);
+	} else {
+		struct game_creature *closest = NULL;
+		int closest_dist2 = FISH_SEPARATION_DISTANCE * FISH_SEPARATION_DISTANCE;
+
+		for (int i = 0; i < game->creature_count; i++) {
+			struct game_creature *other = &game->creatures[i];
+			if (other == fish || other->type == -1 || !other->in_game) { continue; }
+
+			int d2 = dist2(fish->x, fish->y, other->x, other->y);
+			if (d2 <= closest_dist2) {
+				closest = other;
+				closest_dist2 = d2;
+			}
+		}
+
+		if (closest) {
+			set_speed(&fish->vx, &fish->vy, fish->x - closest->x, fish->y - closest->y, FISH_SPEED);
+		} else {
+			set_speed(&fish->vx, &fish->vy, fish->vx, fish->vy, FISH_SPEED);
+		}
+	}
+
+	int top;
+	int bottom;
+	creature_habitat(fish, &top, &bottom);
+	int next_y = fish->y + fish->vy;
+	if (next_y < top || bottom < next_y) { fish->vy = -fish->vy; }
+
+	int next_x = fish->x + fish->vx;
+	if (!fish->fleeing && (next_x < 0 || MAX_X <= next_x)) { fish->vx = -fish->vx; }
+}
+
+static void update_monster_speed(struct game *game, struct game_creature *monster) {
+	struct game_drone *target = NULL;
+	int target_dist2 = INT32_MAX;
+
+	for (int d = 0; d < TOTAL_DRONE_COUNT; d++) {
+		struct game_drone *drone = &game->drones[d];
+		if (drone->emergency) { continue; }
+
+		int range = drone_light_distance(drone);
+		int d2 = dist2(monster->x, monster->y, drone->x, drone->y);
+		if (d2 <= range * range && d2 < target_dist2) {
+			target = drone;
+			target_dist2 = d2;
+		}
+	}
+
+	if (target) {
+		set_speed(&monster->vx, &monster->vy, target->x - monster->x, target->y - monster->y, MONSTER_CHASE_SPEED);
+	} else {
+		struct game_creature *closest = NULL;
+		int closest_dist2 = MONSTER_SEPARATION_DISTANCE * MONSTER_SEPARATION_DISTANCE;
+
+		for (int i = 0; i < game->creature_count; i++) {
+			struct game_creature *other = &game->creatures[i];
+			if (other == monster || other->type != -1) { continue; }
+
+			int d2 = dist2(monster->x, monster->y, other->x, other->y);
+			if (d2 <= closest_dist2) {
+				closest = other;
+				closest_dist2 = d2;
+			}
+		}
+
+		if (closest) {
+			set_speed(&monster->vx, &monster->vy, monster->x - closest->x, monster->y - closest->y, MONSTER_SPEED);
+		} else if (monster->vx || monster->vy) {
+			set_speed(&monster->vx, &monster->vy, monster->vx, monster->vy, MONSTER_SPEED);
+		}
+	}
+
+	int next_x = monster->x + monster->vx;
+	int next_y = monster->y + monster->vy;
+	if (next_x < 0 || MAX_X <= next_x) { monster->vx = -monster->vx; }
+	if (next_y < MONSTER_HABITAT_TOP || MAX_Y <= next_y) { monster->vy = -monster->vy; }
+}
+
+static int combo_count(const struct game *game, uint32_t saved, int color, int type) {
+	int count = 0;
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (!(saved & (1u << i))) { continue; }
+		if (game->creatures[i].color == color) { count += 1; }
+		if (game->creatures[i].type == type) { count += 1; }
+	}
+
+	return count;
+}
+
+static void save_scans(struct game *game, uint32_t saving[PLAYER_COUNT]) {
+	uint32_t saved_before[PLAYER_COUNT];
+	uint32_t combos_before[PLAYER_COUNT];
+
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		saved_before[p] = game->players[p].saved;
+		combos_before[p] = game->players[p].combos;
+	}
+
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		struct game_player *player = &game->players[p];
+		uint32_t new_scans = saving[p] & ~player->saved;
+
+		for (int i = 0; i < FISH_COUNT; i++) {
+			if (!(new_scans & (1u << i))) { continue; }
+
+			int points = game->creatures[i].type + 1;
+			if (!(saved_before[!p] & (1u << i))) { points *= 2; }
+			player->score += points;
+		}
+		player->saved |= new_scans;
+
+		for (int color = 0; color < FISH_COLOR_COUNT; color++) {
+			uint32_t bit = 1u << color;
+			if ((player->combos & bit) || combo_count(game, player->saved, color, -2) < FISH_TYPE_COUNT) { continue; }
+
+			player->combos |= bit;
+			player->score += (combos_before[!p] & bit) ? 3 : 6;
+		}
+
+		for (int type = 0; type < FISH_TYPE_COUNT; type++) {
+			uint32_t bit = 1u << (FISH_COLOR_COUNT + type);
+			if ((player->combos & bit) || combo_count(game, player->saved, -2, type) < FISH_COLOR_COUNT) { continue; }
+
+			player->combos |= bit;
+			player->score += (combos_before[!p] & bit) ? 4 : 8;
+		}
+	}
+}
+
+static bool nothing_left_to_scan(const struct game *game) {
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		uint32_t pending = game->players[p].saved;
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			pending |= game->drones[GAME_DRONE_ID(p, d)].scans;
+		}
+
+		for (int i = 0; i < FISH_COUNT; i++) {
+			if (game->creatures[i].in_game && !(pending & (1u << i))) { return false; }
+		}
+		if (pending != game->players[p].saved) { return false; }
+	}
+
+	return true;
+}
+
+void game_step(struct game *game) {
+	int drone_x0[TOTAL_DRONE_COUNT];
+	int drone_y0[TOTAL_DRONE_COUNT];
+
+	for (int p = 0; p < PLAYER_COUNT; p++) {
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			int drone_id = GAME_DRONE_ID(p, d);
+			drone_x0[drone_id] = game->drones[drone_id].x;
+			drone_y0[drone_id] = game->drones[drone_id].y;
+			move_drone(&game->drones[drone_id], &game->players[p].commands.drones[d]);
+		}
+	}
+
+	for (int i = 0; i < game->creature_count; i++) {
+		if (game->creatures[i].in_game) { move_creature(&game->creatures[i]); }
+	}
+
+	for (int d = 0; d < TOTAL_DRONE_COUNT; d++) {
+		struct game_drone *drone = &game->drones[d];
+		if (drone->emergency) { continue; }
+
+		for (int i = FISH_COUNT; i < game->creature_count; i++) {
+			if (drone_collides(drone_x0[d], drone_y0[d], drone, &game->creatures[i])) {
+				drone->emergency = true;
+				drone->scans = 0;
+				break;
+			}
+		}
+	}
+
+	for (int d = 0; d < TOTAL_DRONE_COUNT; d++) {
+		struct game_drone *drone = &game->drones[d];
+		if (drone->emergency) { continue; }
+
+		int distance = drone_light_distance(drone);
+		for (int i = 0; i < FISH_COUNT; i++) {
+			struct game_creature *fish = &game->creatures[i];
+			if (!fish->in_game) { continue; }
+
+			if (dist2(drone->x, drone->y, fish->x, fish->y) <= distance * distance) {
+				drone->scans |= 1u << i;
+			}
+		}
+	}
+
+	game->turn += 1;
+	game->over = GAME_TURN_MAX <= game->turn;
+
+	uint32_t saving[PLAYER_COUNT] = {};
+	for (int d = 0; d < TOTAL_DRONE_COUNT; d++) {
+		struct game_drone *drone = &game->drones[d];
+
+		if (game->over || drone->y <= DRONE_SCAN_SUBMIT_DEPTH) {
+			saving[GAME_DRONE_PLAYER(d)] |= drone->scans;
+			drone->scans = 0;
+		}
+	}
+	save_scans(game, saving);
+
+	for (int i = 0; i < game->creature_count; i++) {
+		struct game_creature *creature = &game->creatures[i];
+		if (!creature->in_game) { continue; }
+
+		if (creature->type == -1) {
+			update_monster_speed(game, creature);
+		} else {
+			update_fish_speed(game, creature);
+		}
+	}
+
+	if (nothing_left_to_scan(game)) { game->over = true; }
+}
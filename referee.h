@@ -0,0 +1,70 @@
+/*
+ * In-process referee.
+ *
+ * Simulates a match from the game rules as we understand them: drones, fish
+ * habitats, fleeing fish, chasing monsters, scans, saves and combo bonuses.
+ * A struct game owns everything so several games can be simulated at once.
+ *
+ * The per-player view is handed over by filling the engine state, exactly as
+ * parse_round_input() would, and commands come back as struct turn_commands.
+ */
+#ifndef REFEREE_H
+#define REFEREE_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+struct game_creature {
+	int color;    /* -1 for monsters */
+	int type;     /* -1 for monsters */
+	int x;
+	int y;
+	int vx;
+	int vy;
+	bool in_game;
+	bool fleeing;
+};
+
+struct game_drone {
+	int x;
+	int y;
+	int battery;
+	bool light;
+	bool emergency;
+	uint32_t scans; /* bit per FISH_INDEX(), not saved yet */
+};
+
+struct game_player {
+	int score;
+	uint32_t saved;  /* bit per FISH_INDEX() */
+	uint32_t combos; /* bit per color, then bit per type */
+	struct turn_commands commands;
+};
+
+struct game {
+	uint64_t rng;
+	int turn;
+	bool over;
+	int creature_count;
+	struct game_creature creatures[FISH_COUNT + MONSTER_COUNT_MAX];
+	struct game_drone drones[TOTAL_DRONE_COUNT];
+	struct game_player players[PLAYER_COUNT];
+};
+
+#define GAME_DRONE_ID(player, i) ((i) * PLAYER_COUNT + (player))
+#define GAME_DRONE_PLAYER(id) ((id) % PLAYER_COUNT)
+
+uint32_t rng_next(uint64_t *rng);
+int rng_range(uint64_t *rng, int min, int max);
+
+void game_init(struct game *game, uint64_t seed);
+
+/* Fill the engine state the way parse_game_input()/parse_round_input() would. */
+void game_observe_init(const struct game *game);
+void game_observe(const struct game *game, int player);
+
+void game_submit(struct game *game, int player, const struct turn_commands *commands);
+void game_step(struct game *game);
+
+#endif
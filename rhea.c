@@ -0,0 +1,239 @@
+#include <limits.h>
+#include <time.h>
+
+#include "intmath.h"
+#include "rhea.h"
+
+#define COLLISION_PENALTY (1000000)
+#define DISCOUNT_BASE (16) /* a scan at ply p is worth (DISCOUNT_BASE - p) / DISCOUNT_BASE */
+#define TOURNAMENT_SIZE (2)
+#define BATCH_MAX (MAX(RHEA_POPULATION, MOVEMENT_VECTOR_COUNT))
+
+static uint8_t random_gene(uint64_t *rng) {
+	uint32_t bits = next_random(rng);
+	uint8_t gene = bits % MOVEMENT_VECTOR_COUNT;
+	return ((bits >> 16) & 3) ? gene : (gene | RHEA_GENE_LIGHT);
+}
+
+static void randomize(struct rhea_individual *individual, uint64_t *rng) {
+	for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+		for (int ply = 0; ply < RHEA_HORIZON; ply++) {
+			individual->genes[d][ply] = random_gene(rng);
+		}
+	}
+}
+
+void rhea_reset(struct rhea *rhea, uint64_t seed) {
+	rhea->rng = seed ? seed : 1;
+	rhea->population = rhea->buffers[0];
+	rhea->seeded = false;
+	rhea->generations = 0;
+}
+
+void rhea_shift(struct rhea *rhea) {
+	if (!rhea->seeded) {
+		for (int i = 0; i < RHEA_POPULATION; i++) {
+			randomize(&rhea->population[i], &rhea->rng);
+		}
+		rhea->seeded = true;
+		return;
+	}
+
+	for (int i = 0; i < RHEA_POPULATION; i++) {
+		struct rhea_individual *individual = &rhea->population[i];
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			memmove(&individual->genes[d][0], &individual->genes[d][1], RHEA_HORIZON - 1);
+			individual->genes[d][RHEA_HORIZON - 1] = random_gene(&rhea->rng);
+		}
+	}
+}
+
+/* Best remaining fish for a drone at the end of the plan, discounted by how far it is. */
+static int plan_end_value(const struct search_problem *world, int x, int y, uint32_t scans) {
+	int best = 0;
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (!world->fish[i].value || (scans & (1u << i))) { continue; }
+
+		struct vec2d position = world->fish_path[RHEA_HORIZON][i];
+		int dist = abs_dist(x, y, position.x, position.y);
+		best = MAX(best, (int)(((long)world->fish[i].value * DRONE_TURN_MOVE_DISTANCE) / (DRONE_TURN_MOVE_DISTANCE + dist)));
+	}
+
+	return best;
+}
+
+/*
+ * Plays every individual of the batch, ply by ply across the whole batch.
+ * Scans are shared by the two drones, a fish only pays once.
+ */
+static void evaluate(const struct rhea_problem *problem, struct rhea_individual *batch, int count) {
+	const struct search_problem *world = &problem->world;
+	int x[BATCH_MAX][PLAYER_DRONE_COUNT];
+	int y[BATCH_MAX][PLAYER_DRONE_COUNT];
+	int battery[BATCH_MAX][PLAYER_DRONE_COUNT];
+	bool alive[BATCH_MAX][PLAYER_DRONE_COUNT];
+	uint32_t scans[BATCH_MAX];
+
+	assert(count <= BATCH_MAX, "rhea batch of %d is too large\n", count);
+
+	for (int i = 0; i < count; i++) {
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			x[i][d] = problem->drones[d].x;
+			y[i][d] = problem->drones[d].y;
+			battery[i][d] = problem->drones[d].battery;
+			alive[i][d] = problem->drones[d].alive;
+		}
+		scans[i] = world->scans;
+		batch[i].fitness = 0;
+	}
+
+	for (int ply = 0; ply < RHEA_HORIZON; ply++) {
+		const struct vec2d *fish_positions = world->fish_path[ply + 1];
+
+		for (int i = 0; i < count; i++) {
+			for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+				if (!alive[i][d]) { continue; }
+
+				uint8_t gene = batch[i].genes[d][ply];
+				struct vec2d vector = movement_vectors[RHEA_GENE_MOVE(gene)];
+				if (search_collides(world, ply, x[i][d], y[i][d], vector)) {
+					alive[i][d] = false;
+					batch[i].fitness -= COLLISION_PENALTY;
+					continue;
+				}
+
+				x[i][d] = MAX(0, MIN(MAX_X - 1, x[i][d] + vector.x));
+				y[i][d] = MAX(0, MIN(MAX_Y - 1, y[i][d] + vector.y));
+
+				int radius = DRONE_FISH_SCAN_DISTANCE;
+				if ((gene & RHEA_GENE_LIGHT) && DRONE_LIGHT_BATTERY_COST <= battery[i][d]) {
+					radius = DRONE_LIGHT_SCAN_DISTANCE;
+					battery[i][d] -= DRONE_LIGHT_BATTERY_COST;
+				} else {
+					battery[i][d] = MIN(DRONE_BATTERY_MAX, battery[i][d] + 1);
+				}
+
+				for (int f = 0; f < FISH_COUNT; f++) {
+					if (!world->fish[f].value || (scans[i] & (1u << f))) { continue; }
+					if (!within(x[i][d], y[i][d], fish_positions[f].x, fish_positions[f].y, radius)) { continue; }
+
+					scans[i] |= 1u << f;
+					batch[i].fitness += (world->fish[f].value * (DISCOUNT_BASE - ply)) / DISCOUNT_BASE;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+			if (alive[i][d]) { batch[i].fitness += plan_end_value(world, x[i][d], y[i][d], scans[i]); }
+		}
+	}
+}
+
+static void sort_population(struct rhea_individual *population) {
+	for (int i = 1; i < RHEA_POPULATION; i++) {
+		struct rhea_individual individual = population[i];
+		int j = i;
+		for (; 0 < j && population[j - 1].fitness < individual.fitness; j--) {
+			population[j] = population[j - 1];
+		}
+		population[j] = individual;
+	}
+}
+
+static const struct rhea_individual *tournament(const struct rhea_individual *population, uint64_t *rng) {
+	const struct rhea_individual *best = &population[next_random(rng) % RHEA_POPULATION];
+
+	for (int i = 1; i < TOURNAMENT_SIZE; i++) {
+		const struct rhea_individual *other = &population[next_random(rng) % RHEA_POPULATION];
+		if (best->fitness < other->fitness) { best = other; }
+	}
+
+	return best;
+}
+
+static void breed(const struct rhea_individual *a, const struct rhea_individual *b, struct rhea_individual *child, uint64_t *rng) {
+	uint32_t mask = next_random(rng);
+	int mutated = next_random(rng) % (PLAYER_DRONE_COUNT * RHEA_HORIZON);
+
+	for (int d = 0; d < PLAYER_DRONE_COUNT; d++) {
+		for (int ply = 0; ply < RHEA_HORIZON; ply++) {
+			int bit = (d * RHEA_HORIZON) + ply;
+			child->genes[d][ply] = ((mask >> bit) & 1) ? a->genes[d][ply] : b->genes[d][ply];
+		}
+	}
+
+	/* NOTE(benjamin): One gene per child, either a new vector or the light toggled. */
+	uint8_t *gene = &child->genes[mutated / RHEA_HORIZON][mutated % RHEA_HORIZON];
+	if (next_random(rng) & 1) {
+		*gene = (*gene & RHEA_GENE_LIGHT) | (next_random(rng) % MOVEMENT_VECTOR_COUNT);
+	} else {
+		*gene ^= RHEA_GENE_LIGHT;
+	}
+}
+
+static long elapsed_us(const struct timespec *start) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((now.tv_sec - start->tv_sec) * 1000000) + ((now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+void rhea_evolve(struct rhea *rhea, const struct rhea_problem *problem) {
+	assert(problem->world.depth == RHEA_HORIZON, "rhea world depth is %d\n", problem->world.depth);
+	assert(rhea->seeded, "rhea_shift() must run before rhea_evolve()\n");
+
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	evaluate(problem, rhea->population, RHEA_POPULATION);
+	sort_population(rhea->population);
+
+	rhea->generations = 0;
+	while (rhea->generations < RHEA_GENERATIONS_MAX && elapsed_us(&start) < RHEA_BUDGET_US) {
+		struct rhea_individual *next = (rhea->population == rhea->buffers[0]) ? rhea->buffers[1] : rhea->buffers[0];
+
+		memcpy(next, rhea->population, RHEA_ELITE * sizeof(*next));
+		for (int i = RHEA_ELITE; i < RHEA_POPULATION; i++) {
+			breed(tournament(rhea->population, &rhea->rng), tournament(rhea->population, &rhea->rng), &next[i], &rhea->rng);
+		}
+
+		evaluate(problem, &next[RHEA_ELITE], RHEA_POPULATION - RHEA_ELITE);
+		sort_population(next);
+		rhea->population = next;
+		rhea->generations += 1;
+	}
+}
+
+void rhea_root_values(const struct rhea *rhea, const struct rhea_problem *problem, int drone, struct search_result *result) {
+	struct rhea_individual batch[MOVEMENT_VECTOR_COUNT];
+	const struct rhea_drone *start = &problem->drones[drone];
+
+	for (int i = 0; i < MOVEMENT_VECTOR_COUNT; i++) {
+		batch[i] = rhea->population[0];
+		batch[i].genes[drone][0] = (batch[i].genes[drone][0] & RHEA_GENE_LIGHT) | i;
+	}
+	evaluate(problem, batch, MOVEMENT_VECTOR_COUNT);
+
+	/* NOTE(benjamin): The rest of the best plan may not suit another first move, whatever evolved for it counts too. */
+	for (int i = 0; i < RHEA_POPULATION; i++) {
+		const struct rhea_individual *individual = &rhea->population[i];
+		int move = RHEA_GENE_MOVE(individual->genes[drone][0]);
+		batch[move].fitness = MAX(batch[move].fitness, individual->fitness);
+	}
+
+	result->best_move = -1;
+	int best_value = INT_MIN;
+	for (int i = 0; i < MOVEMENT_VECTOR_COUNT; i++) {
+		result->legal[i] = !search_collides(&problem->world, 0, start->x, start->y, movement_vectors[i]);
+		result->values[i] = batch[i].fitness;
+		if (result->legal[i] && best_value < result->values[i]) {
+			best_value = result->values[i];
+			result->best_move = i;
+		}
+	}
+
+	result->nodes = MOVEMENT_VECTOR_COUNT * RHEA_HORIZON;
+	result->stopped = false;
+}
@@ -0,0 +1,67 @@
+/*
+ * Rolling horizon evolution, the alternative to the tree search.
+ *
+ * An individual is a fixed-length plan for both drones, a movement vector and
+ * a light bit per turn. Every generation keeps the best individuals and breeds
+ * the others by tournament, uniform crossover and mutation. All of it happens
+ * in two fixed buffers, so nothing is allocated. The population is evaluated in
+ * one batch, ply by ply, so each fish path stays in cache across the
+ * population.
+ *
+ * The population survives the turn: every individual is shifted forward by
+ * one turn and gets a random last gene, so the best plan of last turn seeds
+ * this one.
+ *
+ * The world is a search problem for the fish paths, their values and the
+ * monsters. Its drone fields are unused, the two drones come separately.
+ */
+#ifndef RHEA_H
+#define RHEA_H
+
+#include <stdint.h>
+
+#include "search.h"
+
+#define RHEA_HORIZON (6)
+#define RHEA_POPULATION (32)
+#define RHEA_ELITE (4)
+#define RHEA_GENERATIONS_MAX (100)
+#define RHEA_BUDGET_US (10000)
+
+#define RHEA_GENE_LIGHT (0x80)
+#define RHEA_GENE_MOVE(gene) ((gene) & ~RHEA_GENE_LIGHT)
+
+struct rhea_drone {
+	int x;
+	int y;
+	int battery;
+	bool alive; /* false for a drone in emergency, its genes are ignored */
+};
+
+struct rhea_problem {
+	struct search_problem world; /* depth must be RHEA_HORIZON */
+	struct rhea_drone drones[PLAYER_DRONE_COUNT];
+};
+
+struct rhea_individual {
+	uint8_t genes[PLAYER_DRONE_COUNT][RHEA_HORIZON];
+	int fitness;
+};
+
+struct rhea {
+	struct rhea_individual buffers[2][RHEA_POPULATION];
+	struct rhea_individual *population; /* sorted best first after rhea_evolve() */
+	uint64_t rng;
+	bool seeded;
+	int generations; /* of the last rhea_evolve() */
+};
+
+void rhea_reset(struct rhea *rhea, uint64_t seed);
+/* Drops the turn just played from every individual, call once per turn before rhea_evolve(). */
+void rhea_shift(struct rhea *rhea);
+void rhea_evolve(struct rhea *rhea, const struct rhea_problem *problem);
+
+/* Values of the best individual with the first move of drone replaced by every movement vector. */
+void rhea_root_values(const struct rhea *rhea, const struct rhea_problem *problem, int drone, struct search_result *result);
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Plays strategies against each other in-process and reports the results.
+ *
+ *     cc -O2 -o runner runner.c match.c referee.c engine.c strategies.c movement.c symmetry.c radar.c danger.c intmath.c surfacing.c endgame.c foe.c lure.c rhea.c eval.c record.c pool.c trace.c fishsim.c tt.c search.c mark*.c node-chaser_mk1.c -lm -pthread
+ *     ./runner <strategy> <strategy> [games] [seed] [record file]
+ *     ./runner --check
+ *
+ * Sides are swapped every other game so both strategies play both starts.
+ * With a record file the positions of every game are appended to it, see
+ * record.h, several runners can share the same file.
+ *
+ * --check runs the debug build checks of the integer math, the collision
+ * table and the danger grid, and reports the largest errors they saw. A
+ * failed check aborts with the offending input.
+ */
+#include <time.h>
+
+#include "danger.h"
+#include "intmath.h"
+#include "mark4.h"
+#include "match.h"
+#include "movement.h"
+#include "record.h"
+#include "search.h"
+
+static const struct strategy *find_strategy_or_die(char *name) {
+	const struct strategy *strategy = find_strategy(name);
+
+	if (!strategy) {
+		fprintf(stderr, "unknown strategy: %s\navailable:", name);
+		for (int i = 0; strategies[i]; i++) {
+			fprintf(stderr, " %s", strategies[i]->name);
+		}
+		fprintf(stderr, "\n");
+		exit(1);
+	}
+
+	return strategy;
+}
+
+static void run_checks(void) {
+	compute_movement_vectors();
+	danger_init();
+	search_collision_table_build();
+
+	struct intmath_errors errors = intmath_check();
+	printf("isqrt: max error %d\n", errors.isqrt);
+	printf("progress_value: max error %d, bound 1\n", errors.progress_value);
+	printf("fixed_kept_share: max error %g, bound %g\n", errors.kept_share, 1.0 / FIXED_ONE);
+	printf("collision table: %ld verdicts, all match the exact test\n", search_collision_check());
+	printf("danger grid: %ld clear moves, none collide in the exact test\n", search_danger_check());
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 2 && !strcmp(argv[1], "--check")) {
+		run_checks();
+		return 0;
+	}
+
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <strategy> <strategy> [games] [seed] [record file]\n       %s --check\n", argv[0], argv[0]);
+		return 1;
+	}
+
+	const struct strategy *contenders[PLAYER_COUNT] = {
+		find_strategy_or_die(argv[1]),
+		find_strategy_or_die(argv[2]),
+	};
+	int games = (4 <= argc) ? atoi(argv[3]) : 100;
+	uint64_t seed = (5 <= argc) ? strtoull(argv[4], NULL, 0) : 1;
+	if (6 <= argc) { record_open(argv[5]); }
+
+	int wins[PLAYER_COUNT] = {};
+	long total_scores[PLAYER_COUNT] = {};
+	long total_turns = 0;
+
+	struct timespec start;
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (int i = 0; i < games; i++) {
+		int swap = i % 2;
+		const struct strategy *players[PLAYER_COUNT] = { contenders[swap], contenders[!swap] };
+		struct match_result result;
+
+		play_match(players, seed + (i / 2), &result);
+
+		int a = result.scores[swap];
+		int b = result.scores[!swap];
+		if (a > b) { wins[0] += 1; }
+		if (b > a) { wins[1] += 1; }
+		total_scores[0] += a;
+		total_scores[1] += b;
+		total_turns += result.turns;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	record_close();
+	double elapsed_us = ((end.tv_sec - start.tv_sec) * 1e6) + ((end.tv_nsec - start.tv_nsec) / 1e3);
+
+	printf("%s: %d wins, avg score %.2f\n", contenders[0]->name, wins[0], (double)total_scores[0] / games);
+	printf("%s: %d wins, avg score %.2f\n", contenders[1]->name, wins[1], (double)total_scores[1] / games);
+	printf("draws: %d\n", games - wins[0] - wins[1]);
+	printf("%d games, avg %.1f turns, %.1f us/game\n", games, (double)total_turns / games, elapsed_us / games);
+	if (mark4_rhea_turns) {
+		printf("rhea: %.1f generations/turn\n", (double)mark4_rhea_generations / mark4_rhea_turns);
+	}
+
+	return 0;
+}
@@ -0,0 +1,489 @@
+#include <limits.h>
+#include <stdatomic.h>
+
+#include "eval.h"
+#include "intmath.h"
+#include "search.h"
+
+#define SEARCH_TRAPPED_VALUE (-1000000)
+#define SEARCH_COLLISION_SAMPLES (4)
+
+void (*search_problem_hook)(const struct search_problem *problem);
+
+struct search_context {
+	const struct search_problem *problem;
+	struct transposition_table *tt;
+	long nodes;
+};
+
+struct search_job {
+	struct search_engine *engine;
+	const struct search_problem *problem;
+	struct search_result *result;
+	atomic_long nodes;
+};
+
+/* NOTE(benjamin): Monsters keep their current speed, good enough for a few turns. */
+static int creature_x(const struct search_creature *creature, int ply) {
+	return MAX(0, MIN(MAX_X - 1, creature->x + (creature->vx * ply)));
+}
+
+static int creature_y(const struct search_creature *creature, int ply) {
+	return MAX(0, MIN(MAX_Y - 1, creature->y + (creature->vy * ply)));
+}
+
+/* NOTE(benjamin): Past the grid's turns every move is flagged, the exact test alone decides. */
+static bool flagged(const struct search_problem *problem, int ply, int x, int y, struct vec2d vector) {
+	int turn = problem->danger_turn + ply + 1;
+	if (!problem->danger || DANGER_TURNS < turn) { return true; }
+
+	for (int i = 0; i <= SEARCH_COLLISION_SAMPLES; i++) {
+		int dx = x + ((vector.x * i) / SEARCH_COLLISION_SAMPLES);
+		int dy = y + ((vector.y * i) / SEARCH_COLLISION_SAMPLES);
+		if (danger_at(problem->danger, dx, dy, turn)) { return true; }
+	}
+
+	return false;
+}
+
+/*
+ * Relative to the monster, the exact test below only depends on the offset
+ * between the drone and the monster and on their relative velocity. The
+ * table buckets both and stores a cell as clear or hit when every offset and
+ * velocity it covers agrees, the cells on the edge of the collision distance
+ * are left to the exact test. Offsets past the table are always clear.
+ */
+#define COLLISION_SHIFT (6) /* 64 units per bucket, for the velocity and the offset alike */
+#define COLLISION_VELOCITY_BUCKETS (36)
+#define COLLISION_VELOCITY_MAX ((COLLISION_VELOCITY_BUCKETS / 2) << COLLISION_SHIFT)
+#define COLLISION_OFFSET_CELLS (56)
+#define COLLISION_OFFSET_MAX ((COLLISION_OFFSET_CELLS / 2) << COLLISION_SHIFT)
+/* NOTE(benjamin): Half a bucket of velocity and of offset on both axes, plus the two truncations of the samples. */
+#define COLLISION_MARGIN (93)
+
+enum collision_verdict {
+	COLLISION_UNKNOWN,
+	COLLISION_CLEAR,
+	COLLISION_HIT,
+};
+
+_Static_assert(DRONE_TURN_MOVE_DISTANCE + MONSTER_CHASE_SPEED < COLLISION_VELOCITY_MAX, "collision table too narrow");
+_Static_assert(MONSTER_COLLISION_DISTANCE + COLLISION_VELOCITY_MAX + 2 < COLLISION_OFFSET_MAX, "collision table too short");
+
+/* NOTE(benjamin): Two bits per cell, four cells per byte, 1 MB in all. */
+static uint8_t collision_table[COLLISION_VELOCITY_BUCKETS][COLLISION_VELOCITY_BUCKETS][COLLISION_OFFSET_CELLS][COLLISION_OFFSET_CELLS / 4];
+/* Buckets built so far, row by row, the others go to the exact test. */
+static int collision_buckets_built;
+
+/*
+ * Bucket centers sit on half units, everything is counted in eighths so the
+ * centers and the samples along a quarter of the speed stay integers.
+ */
+#define COLLISION_EIGHTHS(lo) ((8 * (lo)) + (4 * ((1 << COLLISION_SHIFT) - 1)))
+
+_Static_assert(8 % SEARCH_COLLISION_SAMPLES == 0 && COLLISION_EIGHTHS(0) % SEARCH_COLLISION_SAMPLES == 0, "collision samples off the eighths");
+
+static void build_collision_bucket(int bucket) {
+	int by = bucket / COLLISION_VELOCITY_BUCKETS;
+	int bx = bucket % COLLISION_VELOCITY_BUCKETS;
+	long vx = COLLISION_EIGHTHS((bx << COLLISION_SHIFT) - COLLISION_VELOCITY_MAX);
+	long vy = COLLISION_EIGHTHS((by << COLLISION_SHIFT) - COLLISION_VELOCITY_MAX);
+	long clear = 8L * (MONSTER_COLLISION_DISTANCE + COLLISION_MARGIN);
+	long hit = 8L * (MONSTER_COLLISION_DISTANCE - COLLISION_MARGIN);
+
+	for (int cy = 0; cy < COLLISION_OFFSET_CELLS; cy++) {
+		for (int cx = 0; cx < COLLISION_OFFSET_CELLS; cx++) {
+			long ox = COLLISION_EIGHTHS((cx << COLLISION_SHIFT) - COLLISION_OFFSET_MAX);
+			long oy = COLLISION_EIGHTHS((cy << COLLISION_SHIFT) - COLLISION_OFFSET_MAX);
+
+			long closest = LONG_MAX;
+			for (int i = 0; i <= SEARCH_COLLISION_SAMPLES; i++) {
+				long dx = ox + ((vx * i) / SEARCH_COLLISION_SAMPLES);
+				long dy = oy + ((vy * i) / SEARCH_COLLISION_SAMPLES);
+				closest = MIN(closest, (dx * dx) + (dy * dy));
+			}
+
+			int verdict = (clear * clear < closest) ? COLLISION_CLEAR : (closest < hit * hit) ? COLLISION_HIT : COLLISION_UNKNOWN;
+			collision_table[by][bx][cy][cx / 4] |= verdict << ((cx % 4) * 2);
+		}
+	}
+}
+
+bool search_collision_table_build(void) {
+	int bucket_count = COLLISION_VELOCITY_BUCKETS * COLLISION_VELOCITY_BUCKETS;
+
+	while (collision_buckets_built < bucket_count && !startup_expired()) {
+		build_collision_bucket(collision_buckets_built);
+		collision_buckets_built += 1;
+	}
+
+	return collision_buckets_built == bucket_count;
+}
+
+static enum collision_verdict collision_lookup(int ox, int oy, int vx, int vy) {
+	unsigned bx = (unsigned)(vx + COLLISION_VELOCITY_MAX) >> COLLISION_SHIFT;
+	unsigned by = (unsigned)(vy + COLLISION_VELOCITY_MAX) >> COLLISION_SHIFT;
+	if (COLLISION_VELOCITY_BUCKETS <= bx || COLLISION_VELOCITY_BUCKETS <= by) { return COLLISION_UNKNOWN; }
+	if ((int)((by * COLLISION_VELOCITY_BUCKETS) + bx) >= collision_buckets_built) { return COLLISION_UNKNOWN; }
+
+	unsigned cx = (unsigned)(ox + COLLISION_OFFSET_MAX) >> COLLISION_SHIFT;
+	unsigned cy = (unsigned)(oy + COLLISION_OFFSET_MAX) >> COLLISION_SHIFT;
+	if (COLLISION_OFFSET_CELLS <= cx || COLLISION_OFFSET_CELLS <= cy) { return COLLISION_CLEAR; }
+
+	return (collision_table[by][bx][cy][cx / 4] >> ((cx % 4) * 2)) & 3;
+}
+
+/* The drone at x, y playing vector against a monster at mx, my, sampled along both moves. */
+static bool collides_exact(int x, int y, struct vec2d vector, int mx, int my, int mvx, int mvy) {
+	for (int i = 0; i <= SEARCH_COLLISION_SAMPLES; i++) {
+		int dx = x + ((vector.x * i) / SEARCH_COLLISION_SAMPLES);
+		int dy = y + ((vector.y * i) / SEARCH_COLLISION_SAMPLES);
+		int sx = mx + ((mvx * i) / SEARCH_COLLISION_SAMPLES);
+		int sy = my + ((mvy * i) / SEARCH_COLLISION_SAMPLES);
+
+		if (within(dx, dy, sx, sy, MONSTER_COLLISION_DISTANCE)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+long search_collision_check(void) {
+	uint64_t rng = 1;
+	long compared = 0;
+
+	for (int n = 0; n < 1000000; n++) {
+		int x = (int)(next_random(&rng) % MAX_X);
+		int y = (int)(next_random(&rng) % MAX_Y);
+		struct vec2d vector = movement_vectors[next_random(&rng) % MOVEMENT_VECTOR_COUNT];
+		int mx = x + (int)(next_random(&rng) % 4001) - 2000;
+		int my = y + (int)(next_random(&rng) % 4001) - 2000;
+		int mvx = (int)(next_random(&rng) % ((2 * MONSTER_CHASE_SPEED) + 1)) - MONSTER_CHASE_SPEED;
+		int mvy = (int)(next_random(&rng) % ((2 * MONSTER_CHASE_SPEED) + 1)) - MONSTER_CHASE_SPEED;
+
+		enum collision_verdict verdict = collision_lookup(x - mx, y - my, vector.x - mvx, vector.y - mvy);
+		if (verdict == COLLISION_UNKNOWN) { continue; }
+
+		bool exact = collides_exact(x, y, vector, mx, my, mvx, mvy);
+		assert(exact == (verdict == COLLISION_HIT), "collision table says %d for offset {%d,%d} speed {%d,%d}\n",
+				verdict, x - mx, y - my, vector.x - mvx, vector.y - mvy);
+		compared += 1;
+	}
+
+	return compared;
+}
+
+/* Coordinate within a move of either edge of [0, max[, where the monster guesses get clamped. */
+static int edge_coordinate(uint64_t *rng, int max) {
+	int offset = (int)(next_random(rng) % (2 * MONSTER_CHASE_SPEED));
+	return (next_random(rng) & 1) ? offset : max - 1 - offset;
+}
+
+long search_danger_check(void) {
+	static struct danger_grid grid;
+	struct state saved = state;
+	uint64_t rng = 1;
+	long tested = 0;
+
+	for (int n = 0; n < 20000; n++) {
+		struct fish *monster = &state.entities[TOTAL_DRONE_COUNT].fish;
+		*monster = (struct fish){ .color = -1, .type = -1, .visible = true };
+		monster->x = (n & 1) ? edge_coordinate(&rng, MAX_X) : (int)(next_random(&rng) % MAX_X);
+		monster->y = (n & 2) ? edge_coordinate(&rng, MAX_Y) : (int)(next_random(&rng) % MAX_Y);
+		monster->vx = (int)(next_random(&rng) % ((2 * MONSTER_CHASE_SPEED) + 1)) - MONSTER_CHASE_SPEED;
+		monster->vy = (int)(next_random(&rng) % ((2 * MONSTER_CHASE_SPEED) + 1)) - MONSTER_CHASE_SPEED;
+		state.entity_count = TOTAL_DRONE_COUNT + 1;
+		danger_build(&grid, DANGER_TURNS);
+
+		/* NOTE(benjamin): Later turns search a predicted problem against the same grid. */
+		struct search_creature creature = { monster->x, monster->y, monster->vx, monster->vy, 0 };
+		struct search_problem problem = { .monster_count = 1, .danger = &grid };
+		problem.danger_turn = (int)(next_random(&rng) % DANGER_TURNS);
+		creature.x = creature_x(&creature, problem.danger_turn);
+		creature.y = creature_y(&creature, problem.danger_turn);
+		problem.monsters[0] = creature;
+
+		for (int k = 0; k < 64; k++) {
+			int ply = (int)(next_random(&rng) % (DANGER_TURNS - problem.danger_turn));
+			int mx = creature_x(&creature, ply);
+			int my = creature_y(&creature, ply);
+			int x = MAX(0, MIN(MAX_X - 1, mx + (int)(next_random(&rng) % 3001) - 1500));
+			int y = MAX(0, MIN(MAX_Y - 1, my + (int)(next_random(&rng) % 3001) - 1500));
+			struct vec2d vector = movement_vectors[next_random(&rng) % MOVEMENT_VECTOR_COUNT];
+
+			if (flagged(&problem, ply, x, y, vector)) { continue; }
+			assert(!collides_exact(x, y, vector, mx, my, creature.vx, creature.vy),
+					"danger grid clear for drone {%d,%d} vector {%d,%d} at ply %d, monster {%d,%d} speed {%d,%d} turn %d\n",
+					x, y, vector.x, vector.y, ply, mx, my, creature.vx, creature.vy, problem.danger_turn);
+			tested += 1;
+		}
+	}
+
+	state = saved;
+	return tested;
+}
+
+bool search_collides(const struct search_problem *problem, int ply, int x, int y, struct vec2d vector) {
+	if (!flagged(problem, ply, x, y, vector)) { return false; }
+
+	for (int m = 0; m < problem->monster_count; m++) {
+		const struct search_creature *monster = &problem->monsters[m];
+		int mx = creature_x(monster, ply);
+		int my = creature_y(monster, ply);
+
+		enum collision_verdict verdict = collision_lookup(x - mx, y - my, vector.x - monster->vx, vector.y - monster->vy);
+		if (verdict == COLLISION_HIT) { return true; }
+		if (verdict == COLLISION_CLEAR) { continue; }
+
+		if (collides_exact(x, y, vector, mx, my, monster->vx, monster->vy)) { return true; }
+	}
+
+	return false;
+}
+
+/* Scans every fish in range at the end of the move, returns the value gained. */
+static int scan_fish(const struct search_problem *problem, int ply, int x, int y, int radius, uint32_t *scans) {
+	int gained = 0;
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		const struct search_creature *fish = &problem->fish[i];
+		if (!fish->value || (*scans & (1u << i))) { continue; }
+
+		struct vec2d position = problem->fish_path[ply][i];
+		if (within(x, y, position.x, position.y, radius)) {
+			*scans |= 1u << i;
+			gained += fish->value;
+		}
+	}
+
+	return gained;
+}
+
+/* Best remaining fish, discounted by how far it is. */
+static int leaf_value(const struct search_problem *problem, int ply, int x, int y, uint32_t scans) {
+	int best = 0;
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		const struct search_creature *fish = &problem->fish[i];
+		if (!fish->value || (scans & (1u << i))) { continue; }
+
+		struct vec2d position = problem->fish_path[ply][i];
+		int dist = abs_dist(x, y, position.x, position.y);
+		int value = (int)(((long)fish->value * DRONE_TURN_MOVE_DISTANCE) / (DRONE_TURN_MOVE_DISTANCE + dist));
+		best = MAX(best, value);
+	}
+
+	return best;
+}
+
+/* Applies vector at ply, returns the value scanned by the move. */
+static int apply_move(const struct search_problem *problem, int ply, int *x, int *y, int *battery, uint32_t *scans, struct vec2d vector) {
+	*x = MAX(0, MIN(MAX_X - 1, *x + vector.x));
+	*y = MAX(0, MIN(MAX_Y - 1, *y + vector.y));
+
+	/* NOTE(benjamin): Light whenever two lights are affordable, the search has no say in it. */
+	int radius = DRONE_FISH_SCAN_DISTANCE;
+	if (problem->light_min_depth < *y && (2 * DRONE_LIGHT_BATTERY_COST) <= *battery) {
+		radius = DRONE_LIGHT_SCAN_DISTANCE;
+		*battery -= DRONE_LIGHT_BATTERY_COST;
+	} else {
+		*battery = MIN(DRONE_BATTERY_MAX, *battery + 1);
+	}
+
+	return scan_fish(problem, ply + 1, *x, *y, radius, scans);
+}
+
+static int search_node(struct search_context *ctx, int ply, int depth, int x, int y, int battery, uint32_t scans) {
+	const struct search_problem *problem = ctx->problem;
+	ctx->nodes += 1;
+
+	if (problem->stop && atomic_load_explicit(problem->stop, memory_order_relaxed)) { return 0; }
+	if (!depth) {
+		if (problem->learned_leaf) { return eval_leaf(problem, ply, x, y, battery, scans); }
+		return leaf_value(problem, ply, x, y, scans);
+	}
+
+	uint64_t key = tt_key(x, y, battery, scans, ply);
+	const struct tt_entry *entry = tt_probe(ctx->tt, key, depth);
+	if (entry) { return entry->value; }
+
+	int best_value = SEARCH_TRAPPED_VALUE;
+	int best_move = 0;
+
+	for (int i = 0; i < MOVEMENT_VECTOR_COUNT; i++) {
+		if (search_collides(problem, ply, x, y, movement_vectors[i])) { continue; }
+
+		int next_x = x;
+		int next_y = y;
+		int next_battery = battery;
+		uint32_t next_scans = scans;
+		int value = apply_move(problem, ply, &next_x, &next_y, &next_battery, &next_scans, movement_vectors[i]);
+		value += search_node(ctx, ply + 1, depth - 1, next_x, next_y, next_battery, next_scans);
+
+		if (best_value < value) {
+			best_value = value;
+			best_move = i;
+		}
+	}
+
+	tt_store(ctx->tt, key, depth, best_value, best_move);
+	return best_value;
+}
+
+static void search_root_move(void *arg, int move, int worker) {
+	struct search_job *job = arg;
+	const struct search_problem *problem = job->problem;
+	struct search_result *result = job->result;
+
+	result->legal[move] = !search_collides(problem, 0, problem->drone_x, problem->drone_y, movement_vectors[move]);
+	result->values[move] = SEARCH_TRAPPED_VALUE;
+	if (!result->legal[move]) { return; }
+
+	struct search_context ctx = { .problem = problem, .tt = &job->engine->tts[worker] };
+
+	int x = problem->drone_x;
+	int y = problem->drone_y;
+	int battery = problem->battery;
+	uint32_t scans = problem->scans;
+	int value = apply_move(problem, 0, &x, &y, &battery, &scans, movement_vectors[move]);
+	value += search_node(&ctx, 1, problem->depth - 1, x, y, battery, scans);
+
+	/* NOTE(benjamin): Every root move belongs to a single task, only the node count is shared. */
+	result->values[move] = value;
+	atomic_fetch_add(&job->nodes, ctx.nodes);
+}
+
+int search_subtree_value(const struct search_problem *problem, struct transposition_table *tt, int depth) {
+	struct search_problem plain = *problem;
+	plain.learned_leaf = false;
+
+	struct search_context ctx = { .problem = &plain, .tt = tt };
+	tt_new_search(tt);
+	return search_node(&ctx, 0, depth, plain.drone_x, plain.drone_y, plain.battery, plain.scans);
+}
+
+void search_engine_init(struct search_engine *engine, struct thread_pool *pool, int tt_bucket_bits) {
+	engine->pool = pool;
+
+	for (int i = 0; i < pool->thread_count; i++) {
+		tt_init(&engine->tts[i], tt_bucket_bits);
+	}
+}
+
+struct tt_stats search_engine_tt_stats(const struct search_engine *engine) {
+	struct tt_stats total = {};
+
+	for (int i = 0; i < engine->pool->thread_count; i++) {
+		total.probes += engine->tts[i].stats.probes;
+		total.hits += engine->tts[i].stats.hits;
+		total.stores += engine->tts[i].stats.stores;
+		total.replacements += engine->tts[i].stats.replacements;
+	}
+
+	return total;
+}
+
+void search_drone(struct search_engine *engine, const struct search_problem *problem, struct search_result *result) {
+	assert(0 < problem->depth && problem->depth <= SEARCH_DEPTH_MAX, "bad search depth %d\n", problem->depth);
+	if (search_problem_hook) { search_problem_hook(problem); }
+
+	for (int i = 0; i < engine->pool->thread_count; i++) {
+		tt_new_search(&engine->tts[i]);
+	}
+
+	struct search_job job = { .engine = engine, .problem = problem, .result = result };
+	atomic_init(&job.nodes, 0);
+	pool_run(engine->pool, search_root_move, &job, MOVEMENT_VECTOR_COUNT);
+
+	result->best_move = -1;
+	int best_value = INT_MIN;
+	for (int i = 0; i < MOVEMENT_VECTOR_COUNT; i++) {
+		if (result->legal[i] && best_value < result->values[i]) {
+			best_value = result->values[i];
+			result->best_move = i;
+		}
+	}
+
+	result->nodes = atomic_load(&job.nodes);
+	result->stopped = problem->stop && atomic_load(problem->stop);
+}
+
+static struct search_creature predict_creature(struct search_creature creature) {
+	creature.x = creature_x(&creature, 1);
+	creature.y = creature_y(&creature, 1);
+	return creature;
+}
+
+void search_predict(const struct search_problem *problem, int move, bool light, struct search_problem *next) {
+	*next = *problem;
+	next->danger_turn += 1;
+
+	next->drone_x = MAX(0, MIN(MAX_X - 1, problem->drone_x + movement_vectors[move].x));
+	next->drone_y = MAX(0, MIN(MAX_Y - 1, problem->drone_y + movement_vectors[move].y));
+	if (light && DRONE_LIGHT_BATTERY_COST <= problem->battery) {
+		next->battery = problem->battery - DRONE_LIGHT_BATTERY_COST;
+	} else {
+		next->battery = MIN(DRONE_BATTERY_MAX, problem->battery + 1);
+	}
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		next->fish[i].x = problem->fish_path[1][i].x;
+		next->fish[i].y = problem->fish_path[1][i].y;
+	}
+
+	for (int ply = 0; ply < problem->depth; ply++) {
+		memcpy(next->fish_path[ply], problem->fish_path[ply + 1], sizeof(next->fish_path[ply]));
+	}
+	for (int i = 0; i < FISH_COUNT; i++) {
+		struct vec2d last = problem->fish_path[problem->depth][i];
+		struct vec2d before = problem->fish_path[problem->depth - 1][i];
+		next->fish_path[problem->depth][i] = (struct vec2d){ last.x + (last.x - before.x), last.y + (last.y - before.y) };
+	}
+	for (int i = 0; i < problem->monster_count; i++) {
+		next->monsters[i] = predict_creature(problem->monsters[i]);
+	}
+}
+
+void search_roll_fish(struct search_problem *problem, const struct fish_school *school, const struct fish_drones *drones, const struct foe_forecast *foe) {
+	struct fish_school rolled = *school;
+	struct fish_drones moved = *drones;
+	struct foe_forecast forecast;
+	if (foe) { forecast = *foe; }
+
+	for (int ply = 0; ply <= problem->depth; ply++) {
+		if (ply && foe) { foe_step(&forecast, &rolled, &moved); }
+		if (ply) { fish_school_step(&rolled, &moved); }
+
+		for (int i = 0; i < FISH_COUNT; i++) {
+			problem->fish_path[ply][i] = (struct vec2d){ (int)rolled.x[i], (int)rolled.y[i] };
+		}
+	}
+}
+
+static bool creature_close(const struct search_creature *a, const struct search_creature *b) {
+	return a->value == b->value && abs_dist(a->x, a->y, b->x, b->y) <= SEARCH_PREDICTION_TOLERANCE;
+}
+
+bool search_prediction_holds(const struct search_problem *predicted, const struct search_problem *actual) {
+	if (predicted->depth != actual->depth || predicted->battery != actual->battery || predicted->scans != actual->scans ||
+			predicted->light_min_depth != actual->light_min_depth || predicted->monster_count != actual->monster_count) {
+		return false;
+	}
+
+	/* NOTE(benjamin): Only a prediction made on the turn before, it was searched on that turn's danger grid. */
+	if (predicted->danger_turn != actual->danger_turn + 1) { return false; }
+
+	if (SEARCH_PREDICTION_TOLERANCE < abs_dist(predicted->drone_x, predicted->drone_y, actual->drone_x, actual->drone_y)) {
+		return false;
+	}
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (!creature_close(&predicted->fish[i], &actual->fish[i])) { return false; }
+	}
+	for (int i = 0; i < actual->monster_count; i++) {
+		if (!creature_close(&predicted->monsters[i], &actual->monsters[i])) { return false; }
+	}
+
+	return true;
+}
@@ -0,0 +1,100 @@
+/*
+ * Multi-turn lookahead for a single drone over the movement vectors.
+ *
+ * Works on its own copy of the drone, fish and monster estimates so it never
+ * reads the engine state while searching. Fish follow paths rolled out by
+ * the fish simulator, monsters move in a straight line at their estimated
+ * speed. Fish within the scan radius are scanned, and moves into a predicted
+ * monster collision are skipped. With a danger grid, only moves through
+ * flagged cells get the exact collision test. Leaves are worth the best
+ * remaining fish discounted by its distance, or eval_leaf() when asked.
+ *
+ * The root moves are split across the pool threads, each worker searches
+ * with its own transposition table and writes the values of its root moves.
+ */
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "danger.h"
+#include "engine.h"
+#include "fishsim.h"
+#include "foe.h"
+#include "movement.h"
+#include "pool.h"
+#include "tt.h"
+
+#define SEARCH_DEPTH_MAX (TT_PLY_MAX - 1)
+/* Creatures further than this from their predicted position make a pondered search useless. */
+#define SEARCH_PREDICTION_TOLERANCE (500)
+
+struct search_creature {
+	int x;
+	int y;
+	int vx;
+	int vy;
+	int value; /* fish only, 0 when not worth scanning */
+};
+
+struct search_problem {
+	int drone_x;
+	int drone_y;
+	int battery;
+	int light_min_depth;
+	uint32_t scans; /* bit per FISH_INDEX(), already scanned */
+	int depth;
+	struct search_creature fish[FISH_COUNT];
+	struct vec2d fish_path[SEARCH_DEPTH_MAX + 1][FISH_COUNT]; /* position at every ply, see search_roll_fish() */
+	int monster_count;
+	struct search_creature monsters[MONSTER_COUNT_MAX];
+	const struct danger_grid *danger; /* may be NULL, every move gets the exact collision test then */
+	int danger_turn; /* turns played since the grid was built */
+	bool learned_leaf; /* leaves scored by eval_leaf() instead of the nearest fish */
+	atomic_bool *stop; /* may be NULL, the search gives up once set */
+};
+
+struct search_result {
+	bool legal[MOVEMENT_VECTOR_COUNT];
+	int values[MOVEMENT_VECTOR_COUNT];
+	int best_move;
+	long nodes;
+	bool stopped; /* values are meaningless */
+};
+
+struct search_engine {
+	struct thread_pool *pool;
+	struct transposition_table tts[POOL_THREADS_MAX]; /* one per worker */
+};
+
+/* Called with every problem search_drone() is given, only set by eval_train. */
+extern void (*search_problem_hook)(const struct search_problem *problem);
+
+/* Best value depth plies from the root of problem on a single thread, always with the plain leaf value. */
+int search_subtree_value(const struct search_problem *problem, struct transposition_table *tt, int depth);
+
+void search_engine_init(struct search_engine *engine, struct thread_pool *pool, int tt_bucket_bits);
+struct tt_stats search_engine_tt_stats(const struct search_engine *engine);
+
+void search_drone(struct search_engine *engine, const struct search_problem *problem, struct search_result *result);
+
+/* Builds the collision table until the startup deadline, true once complete. Later calls pick up where it stopped, mark4 resumes it after every turn's commands. */
+bool search_collision_table_build(void);
+/* Asserts the table against the exact test on random moves, returns how many verdicts were compared. Slow, meant for debug builds and runner --check. */
+long search_collision_check(void);
+/* Asserts a move the danger grid leaves clear never collides in the exact test, monsters near the map edges included. Returns how many clear moves were tested. */
+long search_danger_check(void);
+
+/* Whether vector played at ply runs into a monster. */
+bool search_collides(const struct search_problem *problem, int ply, int x, int y, struct vec2d vector);
+
+/* Fills the fish paths by stepping school, drones stay where they are unless foe moves the foe ones. */
+void search_roll_fish(struct search_problem *problem, const struct fish_school *school, const struct fish_drones *drones, const struct foe_forecast *foe);
+
+/* Expected problem of the next turn once the drone played move. */
+void search_predict(const struct search_problem *problem, int move, bool light, struct search_problem *next);
+/* Whether a search of predicted, from search_predict() on the turn before, can stand in for a search of actual. */
+bool search_prediction_holds(const struct search_problem *predicted, const struct search_problem *actual);
+
+#endif
@@ -0,0 +1,35 @@
+#include "engine.h"
+
+/* NOTE(benjamin): amalgamate.sh only bundles mark4, the older generations clash with it in a single file. */
+#ifndef MARK4_ONLY
+extern const struct strategy mark1_strategy;
+extern const struct strategy mark2_strategy;
+extern const struct strategy mark3_strategy;
+extern const struct strategy node_chaser_mk1_strategy;
+#endif
+extern const struct strategy mark4_strategy;
+extern const struct strategy mark4_rhea_strategy;
+extern const struct strategy mark4_eval_strategy;
+
+const struct strategy *const strategies[] = {
+#ifndef MARK4_ONLY
+	&mark1_strategy,
+	&mark2_strategy,
+	&mark3_strategy,
+#endif
+	&mark4_strategy,
+	&mark4_rhea_strategy,
+	&mark4_eval_strategy,
+#ifndef MARK4_ONLY
+	&node_chaser_mk1_strategy,
+#endif
+	NULL,
+};
+
+const struct strategy *find_strategy(char *name) {
+	for (int i = 0; strategies[i]; i++) {
+		if (!strcmp(strategies[i]->name, name)) { return strategies[i]; }
+	}
+
+	return NULL;
+}
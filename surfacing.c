@@ -0,0 +1,191 @@
+#include "intmath.h"
+#include "surfacing.h"
+
+/* NOTE(benjamin): Rebuilt by surfacing_begin_turn(), each player overwrites it in self play. */
+static struct {
+	uint32_t my_saved;
+	uint32_t foe_saved;
+	uint32_t pending[TOTAL_DRONE_COUNT];
+	int save_turns[TOTAL_DRONE_COUNT]; /* SURFACING_NEVER when the drone has nothing to save */
+	bool mine[TOTAL_DRONE_COUNT];
+	bool rising[TOTAL_DRONE_COUNT];
+} prediction;
+
+static uint32_t drone_pending(const struct drone *drone, uint32_t saved) {
+	uint32_t pending = 0;
+	for (int i = 0; i < drone->scan_count; i++) {
+		pending |= 1u << FISH_INDEX(drone->scans[i]);
+	}
+	return pending & ~saved;
+}
+
+static uint32_t player_saved(const struct player_state *player) {
+	uint32_t saved = 0;
+	for (int i = 0; i < player->scan_count; i++) {
+		saved |= 1u << FISH_INDEX(player->scans[i]);
+	}
+	return saved;
+}
+
+int surfacing_turns(int y) {
+	int rise = y - DRONE_SCAN_SUBMIT_DEPTH;
+	return (rise <= 0) ? 0 : ((rise + DRONE_TURN_MOVE_DISTANCE - 1) / DRONE_TURN_MOVE_DISTANCE);
+}
+
+void surfacing_begin_turn(void) {
+	prediction.my_saved = player_saved(&state.my);
+	prediction.foe_saved = player_saved(&state.foe);
+
+	for (int id = 0; id < TOTAL_DRONE_COUNT; id++) {
+		struct drone *drone = &state.entities[id].drone;
+		prediction.mine[id] = (state.my.drones[0] == id || state.my.drones[1] == id);
+		prediction.pending[id] = drone_pending(drone, prediction.mine[id] ? prediction.my_saved : prediction.foe_saved);
+
+		prediction.rising[id] = drone->y < drone->last_y;
+		prediction.save_turns[id] = SURFACING_NEVER;
+		if (prediction.pending[id] && !drone->emergency) {
+			prediction.save_turns[id] = surfacing_turns(drone->y) + (prediction.rising[id] ? 0 : SURFACING_DAWDLE_TURNS);
+		}
+		drone->last_y = drone->y;
+	}
+}
+
+bool surfacing_rising(int drone_id) {
+	return prediction.rising[drone_id];
+}
+
+static uint32_t saved_before(bool mine, int turns, int excluded_id, bool ties) {
+	uint32_t saved = mine ? prediction.my_saved : prediction.foe_saved;
+
+	for (int id = 0; id < TOTAL_DRONE_COUNT; id++) {
+		if (prediction.mine[id] != mine || id == excluded_id) { continue; }
+		if (prediction.save_turns[id] < turns || (ties && prediction.save_turns[id] == turns)) {
+			saved |= prediction.pending[id];
+		}
+	}
+
+	return saved;
+}
+
+static bool combo_complete(uint32_t saved, int color, int type) {
+	int count = 0;
+
+	for (int id = TOTAL_DRONE_COUNT; id < TOTAL_DRONE_COUNT + FISH_COUNT; id++) {
+		struct fish *fish = &state.entities[id].fish;
+		if (!(saved & (1u << FISH_INDEX(id)))) { continue; }
+		count += (fish->color == color) || (fish->type == type);
+	}
+
+	return count == ((color == -1) ? FISH_COLOR_COUNT : FISH_TYPE_COUNT);
+}
+
+static int score_saving(uint32_t scans, uint32_t my_before, int turns) {
+	/* NOTE(benjamin): The foe saving on the same turn does not take the first bonus away. */
+	uint32_t foe_before = saved_before(false, turns, -1, false);
+	uint32_t my_after = my_before | scans;
+	uint32_t gained = scans & ~my_before;
+	int score = 0;
+
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (!(gained & (1u << i))) { continue; }
+		int points = state.entities[TOTAL_DRONE_COUNT + i].fish.type + 1;
+		score += (foe_before & (1u << i)) ? points : 2 * points;
+	}
+
+	for (int color = 0; color < FISH_COLOR_COUNT; color++) {
+		if (combo_complete(my_before, color, -1) || !combo_complete(my_after, color, -1)) { continue; }
+		score += combo_complete(foe_before, color, -1) ? 3 : 6;
+	}
+	for (int type = 0; type < FISH_TYPE_COUNT; type++) {
+		if (combo_complete(my_before, -1, type) || !combo_complete(my_after, -1, type)) { continue; }
+		score += combo_complete(foe_before, -1, type) ? 4 : 8;
+	}
+
+	return score;
+}
+
+int surfacing_score(int drone_id, uint32_t scans, uint32_t my_extra, int turns) {
+	return score_saving(scans, saved_before(true, turns, drone_id, true) | my_extra, turns);
+}
+
+int surfacing_reach_turns(int x, int y, const struct fish *fish) {
+	int distance = int_distance(x, y, fish->x, fish->y) - DRONE_FISH_SCAN_DISTANCE;
+	return (distance <= 0) ? 0 : ((distance + DRONE_TURN_MOVE_DISTANCE - 1) / DRONE_TURN_MOVE_DISTANCE);
+}
+
+/* Nearest neighbour chain over the fish nobody of mine has, excluded included. */
+static void build_chain(const struct drone *drone, uint32_t excluded, struct surfacing_plan *plan) {
+	int x = drone->x;
+	int y = drone->y;
+	plan->chain_count = 0;
+
+	while (plan->chain_count < SURFACING_CHAIN_MAX) {
+		int best_id = -1;
+		int best_turns = SURFACING_NEVER;
+
+		for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+			struct fish *fish = &state.entities[id].fish;
+			if (fish->type == -1 || fish->unavailable || (excluded & (1u << FISH_INDEX(id)))) { continue; }
+
+			int turns = surfacing_reach_turns(x, y, fish);
+			if (turns < best_turns) {
+				best_turns = turns;
+				best_id = id;
+			}
+		}
+		if (best_id < 0) { break; }
+
+		plan->chain[plan->chain_count] = best_id;
+		plan->chain_count += 1;
+		excluded |= 1u << FISH_INDEX(best_id);
+		x = state.entities[best_id].fish.x;
+		y = state.entities[best_id].fish.y;
+	}
+}
+
+void surfacing_plan_drone(const struct drone *drone, struct surfacing_plan *plan) {
+	int drone_id = ENTITY_ID(drone);
+	uint32_t mine = prediction.my_saved;
+	for (int id = 0; id < TOTAL_DRONE_COUNT; id++) {
+		if (prediction.mine[id]) { mine |= prediction.pending[id]; }
+	}
+
+	plan->pending = prediction.pending[drone_id];
+	plan->surface_turns = surfacing_turns(drone->y);
+	build_chain(drone, mine, plan);
+
+	int bank_now = surfacing_score(drone_id, plan->pending, 0, plan->surface_turns);
+	plan->bank_now_value = bank_now;
+	plan->fetch_first_value = bank_now;
+	plan->fetch_count = 0;
+
+	/* NOTE(benjamin): Both orders visit the chain the same way, only the first leg and the extra climb differ. */
+	int from_drone = 0;
+	int from_surface = 0;
+	int x = drone->x;
+	int y = drone->y;
+	int best_gain = 0;
+	uint32_t chain = 0;
+
+	for (int k = 0; k < plan->chain_count; k++) {
+		const struct fish *fish = &state.entities[plan->chain[k]].fish;
+		from_drone += surfacing_reach_turns(x, y, fish);
+		from_surface += surfacing_reach_turns(k ? x : drone->x, k ? y : DRONE_SCAN_SUBMIT_DEPTH, fish);
+		chain |= 1u << FISH_INDEX(plan->chain[k]);
+		x = fish->x;
+		y = fish->y;
+
+		int fetch_turns = from_drone + surfacing_turns(y);
+		int fetch_first = surfacing_score(drone_id, plan->pending | chain, 0, fetch_turns);
+
+		int return_turns = plan->surface_turns + from_surface + surfacing_turns(y);
+		int bank_first = bank_now + surfacing_score(drone_id, chain, plan->pending, return_turns);
+
+		if (best_gain < fetch_first - bank_first) {
+			best_gain = fetch_first - bank_first;
+			plan->fetch_count = k + 1;
+			plan->bank_now_value = bank_first;
+			plan->fetch_first_value = fetch_first;
+		}
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ * Surfacing planner, when to bank the scans a drone carries.
+ *
+ * Every drone is predicted to save its scans when it reaches the surface: a
+ * rising drone goes straight up, any other one is assumed to dawdle a few
+ * turns first. Saving is scored with the game rules against those
+ * predictions, so fish and combos the foe banks earlier lose their first
+ * bonus.
+ *
+ * For a drone the planner lines up the nearest unscanned fish and compares,
+ * for every k, fetching k of them before surfacing with surfacing now and
+ * coming back for them. Everything is closed form, a handful of passes over
+ * the fish, cheap enough for a search heuristic.
+ */
+#ifndef SURFACING_H
+#define SURFACING_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+#define SURFACING_CHAIN_MAX (4)
+#define SURFACING_DAWDLE_TURNS (5) /* extra turns before a drone that is not rising saves */
+#define SURFACING_NEVER (GAME_TURN_MAX)
+
+struct surfacing_plan {
+	uint32_t pending; /* bit per FISH_INDEX(), scanned and not saved */
+	int surface_turns; /* straight up from where the drone is */
+	int chain_count;
+	int chain[SURFACING_CHAIN_MAX]; /* fish IDs, nearest first */
+	int bank_now_value;  /* game points of surfacing now, then fetching the best chain */
+	int fetch_first_value; /* game points of fetching the best chain, then surfacing */
+	int fetch_count; /* fish of the chain to fetch before surfacing, 0 to surface now */
+};
+
+/* Predicts when every drone saves, call once per turn before planning. */
+void surfacing_begin_turn(void);
+
+/* Whether the drone moved up last turn. */
+bool surfacing_rising(int drone_id);
+
+int surfacing_turns(int y);
+/* Turns to get a fish within scan range, moving straight at it. */
+int surfacing_reach_turns(int x, int y, const struct fish *fish);
+
+/* Game points of drone_id saving scans in turns, my_extra being saved by then too. */
+int surfacing_score(int drone_id, uint32_t scans, uint32_t my_extra, int turns);
+
+void surfacing_plan_drone(const struct drone *drone, struct surfacing_plan *plan);
+
+static inline bool surfacing_should_bank(const struct surfacing_plan *plan) {
+	return plan->pending && !plan->fetch_count;
+}
+
+#endif
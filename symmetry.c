@@ -0,0 +1,72 @@
+#include "symmetry.h"
+
+static int symmetry_partners[MAX_ENTITIES];
+
+void compute_symmetry_partners(void) {
+	int previous_monster = -1;
+
+	for (int id = 0; id < ARRLEN(symmetry_partners); id++) {
+		symmetry_partners[id] = -1;
+	}
+
+	for (int id = TOTAL_DRONE_COUNT; id < state.entity_count; id++) {
+		struct fish *fish = &state.entities[id].fish;
+
+		if (fish->type == -1) {
+			if (previous_monster == -1) {
+				previous_monster = id;
+			} else {
+				symmetry_partners[id] = previous_monster;
+				symmetry_partners[previous_monster] = id;
+				previous_monster = -1;
+			}
+			continue;
+		}
+
+		for (int other_id = TOTAL_DRONE_COUNT; other_id < state.entity_count; other_id++) {
+			struct fish *other = &state.entities[other_id].fish;
+
+			if (other->type == fish->type && other->color == (fish->color ^ 1)) {
+				symmetry_partners[id] = other_id;
+			}
+		}
+	}
+}
+
+int symmetry_partner(int creature_id) {
+	return symmetry_partners[creature_id];
+}
+
+struct box mirror_box(struct box box) {
+	struct box mirrored = {
+		.left_x = MIRROR_X(box.right_x),
+		.right_x = MIRROR_X(box.left_x),
+		.top_y = box.top_y,
+		.bottom_y = box.bottom_y,
+	};
+
+	return mirrored;
+}
+
+bool intersect_box(struct box *box, struct box other) {
+	struct box intersection = {
+		.left_x = MAX(box->left_x, other.left_x),
+		.right_x = MIN(box->right_x, other.right_x),
+		.top_y = MAX(box->top_y, other.top_y),
+		.bottom_y = MIN(box->bottom_y, other.bottom_y),
+	};
+
+	if (intersection.right_x < intersection.left_x || intersection.bottom_y < intersection.top_y) {
+		return false;
+	}
+
+	*box = intersection;
+	return true;
+}
+
+int box_dist2(struct box box, int x, int y) {
+	int dx = (x < box.left_x) ? box.left_x - x : (box.right_x < x) ? x - box.right_x : 0;
+	int dy = (y < box.top_y) ? box.top_y - y : (box.bottom_y < y) ? y - box.bottom_y : 0;
+
+	return (dx * dx) + (dy * dy);
+}
@@ -0,0 +1,36 @@
+/*
+ * Map symmetry helpers.
+ *
+ * Creatures spawn in pairs mirrored around x=5000. A fish and its partner
+ * share the type and have the paired color (0/1, 2/3); monsters are paired
+ * by their order. Until a drone scares one of them, both keep mirrored
+ * positions and speeds.
+ */
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "engine.h"
+
+#define MIRROR_X(x) ((MAX_X - 1) - (x))
+#define IS_MIRRORED_SIDE(x) ((MAX_X / 2) <= (x))
+#define CANONICAL_X(x) (IS_MIRRORED_SIDE(x) ? MIRROR_X(x) : (x))
+
+struct box {
+	int left_x;
+	int right_x;
+	int top_y;
+	int bottom_y;
+};
+
+/* Fills the partner table from the creature colors and types, call once the creatures are known. */
+void compute_symmetry_partners(void);
+/* Partner creature ID, -1 when the creature has none. */
+int symmetry_partner(int creature_id);
+
+struct box mirror_box(struct box box);
+/* False when the boxes do not overlap, box is left untouched then. */
+bool intersect_box(struct box *box, struct box other);
+/* Squared distance from a point to the closest point of the box. */
+int box_dist2(struct box box, int x, int y);
+
+#endif
@@ -0,0 +1,151 @@
+#include <stdatomic.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "trace.h"
+
+#ifndef SINGLE_THREADED
+#include <pthread.h>
+#endif
+
+static FILE *trace_file;
+static int trace_turn;
+static uint64_t trace_state_hash;
+
+static struct trace_record ring[TRACE_RING_SIZE];
+static atomic_uint ring_head; /* written by the turn */
+static atomic_uint ring_tail; /* written by the writer */
+static atomic_ulong ring_dropped;
+
+#ifndef SINGLE_THREADED
+static pthread_t writer_thread;
+static atomic_bool writer_stopping;
+#endif
+
+static void push(struct trace_record *record) {
+	unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+	unsigned tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+
+	if (head - tail == TRACE_RING_SIZE) {
+		atomic_fetch_add_explicit(&ring_dropped, 1, memory_order_relaxed);
+		return;
+	}
+
+	record->turn = trace_turn;
+	ring[head & (TRACE_RING_SIZE - 1)] = *record;
+	atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+}
+
+/* Writes whatever is in the ring, returns false when it was empty. */
+static bool drain(void) {
+	unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+	unsigned head = atomic_load_explicit(&ring_head, memory_order_acquire);
+	if (head == tail) { return false; }
+
+	while (tail != head) {
+		unsigned start = tail & (TRACE_RING_SIZE - 1);
+		unsigned count = MIN(head - tail, TRACE_RING_SIZE - start);
+
+		fwrite(&ring[start], sizeof(ring[0]), count, trace_file);
+		tail += count;
+	}
+
+	atomic_store_explicit(&ring_tail, tail, memory_order_release);
+	return true;
+}
+
+#ifndef SINGLE_THREADED
+static void *writer_main(void *arg) {
+	(void)arg;
+	const struct timespec pause = { 0, 1000000 };
+
+	while (!atomic_load(&writer_stopping)) {
+		if (!drain()) { nanosleep(&pause, NULL); }
+	}
+
+	return NULL;
+}
+#endif
+
+void trace_open(const char *path) {
+	trace_file = fopen(path, "wb");
+	assert(trace_file, "cannot open trace file %s\n", path);
+
+	struct trace_header header = { TRACE_MAGIC, sizeof(struct trace_record) };
+	fwrite(&header, sizeof(header), 1, trace_file);
+
+#ifndef SINGLE_THREADED
+	atomic_store(&writer_stopping, false);
+	assert(pthread_create(&writer_thread, NULL, writer_main, NULL) == 0, "cannot spawn the trace writer\n");
+#endif
+}
+
+void trace_close(void) {
+	if (!trace_file) { return; }
+
+#ifndef SINGLE_THREADED
+	atomic_store(&writer_stopping, true);
+	pthread_join(writer_thread, NULL);
+#endif
+	drain();
+
+	struct trace_record footer = { .type = TRACE_DROPPED, .turn = trace_turn };
+	footer.dropped.count = atomic_load(&ring_dropped);
+	fwrite(&footer, sizeof(footer), 1, trace_file);
+
+	fclose(trace_file);
+	trace_file = NULL;
+}
+
+/* NOTE(benjamin): FNV-1a over the parsed state, enough to spot two runs diverging. */
+static uint64_t state_hash(void) {
+	const unsigned char *bytes = (const unsigned char *)&state;
+	size_t size = offsetof(struct state, entities) + (state.entity_count * sizeof(state.entities[0]));
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+void trace_begin_turn(void) {
+	trace_turn += 1;
+	if (trace_file) { trace_state_hash = state_hash(); }
+}
+
+void trace_end_turn(uint32_t plan_us) {
+	if (!trace_file) { return; }
+
+	struct trace_record record = { .type = TRACE_TURN };
+	record.summary.state_hash = trace_state_hash;
+	record.summary.plan_us = plan_us;
+	push(&record);
+
+#ifdef SINGLE_THREADED
+	drain();
+#endif
+}
+
+void trace_vector(int drone, int vector, bool pruned, int fish, int scan, int drone_score, int explore, int search, int total) {
+	if (!trace_file) { return; }
+
+	struct trace_record record = { .type = TRACE_VECTOR, .drone = drone, .vector = vector, .flags = pruned ? TRACE_PRUNED : 0 };
+	record.scores.fish = fish;
+	record.scores.scan = scan;
+	record.scores.drone = drone_score;
+	record.scores.explore = explore;
+	record.scores.search = search;
+	record.scores.total = total;
+	push(&record);
+}
+
+void trace_action(int drone, int vector, int x, int y, int light) {
+	if (!trace_file) { return; }
+
+	struct trace_record record = { .type = TRACE_ACTION, .drone = drone, .vector = vector, .light = light };
+	record.action.x = x;
+	record.action.y = y;
+	push(&record);
+}
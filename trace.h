@@ -0,0 +1,62 @@
+/*
+ * Binary trace of the decisions, for offline analysis with trace_dump.
+ *
+ * Records are fixed size and go through a single producer ring buffer, a
+ * writer thread drains it to the file so the turn never waits on the disk.
+ * A full ring drops records instead of blocking, the count is in the footer.
+ * With -DSINGLE_THREADED the ring is drained after the commands are printed.
+ *
+ * File layout: struct trace_header, then struct trace_record until the end.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+#define TRACE_MAGIC (0x32435254) /* "TRC2" */
+#define TRACE_RING_SIZE (4096)   /* records, power of two */
+
+enum trace_record_type {
+	TRACE_TURN,   /* summary of the turn, after its other records */
+	TRACE_VECTOR, /* score components of one candidate vector */
+	TRACE_ACTION, /* chosen action of a drone */
+	TRACE_DROPPED /* dropped.count, last record of the file */
+};
+
+#define TRACE_PRUNED (1 << 0) /* TRACE_VECTOR never evaluated, fish and total are upper bounds */
+
+struct trace_record {
+	uint8_t type;
+	uint8_t drone;  /* entity id */
+	uint8_t vector; /* movement vector index */
+	uint8_t light;
+	uint16_t turn;
+	uint16_t flags;
+	union {
+		struct { uint64_t state_hash; uint32_t plan_us; } summary;
+		struct { int32_t fish; int32_t scan; int32_t drone; int32_t explore; int32_t search; int32_t total; } scores;
+		struct { int32_t x; int32_t y; } action;
+		struct { uint64_t count; } dropped;
+	};
+};
+
+struct trace_header {
+	uint32_t magic;
+	uint32_t record_size;
+};
+
+/* Starts tracing to path, tracing stays off when never called. */
+void trace_open(const char *path);
+void trace_close(void);
+
+/* Called by engine_run() around every turn, the state is hashed as parsed. */
+void trace_begin_turn(void);
+void trace_end_turn(uint32_t plan_us);
+
+/* With pruned the fish score and the total are the bounds the vector was cut on. */
+void trace_vector(int drone, int vector, bool pruned, int fish, int scan, int drone_score, int explore, int search, int total);
+void trace_action(int drone, int vector, int x, int y, int light);
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Turns a bot trace into CSV.
+ *
+ *     cc -O2 -o trace_dump trace_dump.c engine.c trace.c movement.c -lm -pthread
+ *     ./trace_dump <trace file> [vectors|heatmap] > trace.csv
+ *
+ * vectors: one row per candidate vector with its score components, pruned
+ *          ones flagged, their fish score and total are the bounds.
+ * heatmap: one row per drone and turn, the total of every movement vector,
+ *          written <=bound for pruned ones.
+ */
+#include "movement.h"
+#include "trace.h"
+
+#define TURN_RECORDS_MAX (256)
+
+static bool heatmap;
+
+static void print_header(void) {
+	if (heatmap) {
+		printf("turn,drone,chosen");
+		for (int i = 0; i < MOVEMENT_VECTOR_COUNT; i++) {
+			printf(",v%d", i);
+		}
+		printf("\n");
+		return;
+	}
+
+	printf("turn,drone,vector,vx,vy,fish,scan,drone_score,explore,search,total,pruned,chosen,light,plan_us,state_hash\n");
+}
+
+static const struct trace_record *find_action(const struct trace_record *records, int count, int drone) {
+	for (int i = 0; i < count; i++) {
+		if (records[i].type == TRACE_ACTION && records[i].drone == drone) { return &records[i]; }
+	}
+
+	return NULL;
+}
+
+static void print_heatmap_turn(const struct trace_record *records, int count) {
+	for (int drone = 0; drone < TOTAL_DRONE_COUNT; drone++) {
+		const struct trace_record *action = find_action(records, count, drone);
+		if (!action) { continue; }
+
+		const struct trace_record *vectors[MOVEMENT_VECTOR_COUNT] = {};
+		for (int i = 0; i < count; i++) {
+			if (records[i].type != TRACE_VECTOR || records[i].drone != drone) { continue; }
+			vectors[records[i].vector] = &records[i];
+		}
+
+		printf("%d,%d,%d", action->turn, drone, action->vector);
+		for (int i = 0; i < MOVEMENT_VECTOR_COUNT; i++) {
+			if (!vectors[i]) { printf(","); continue; }
+			printf((vectors[i]->flags & TRACE_PRUNED) ? ",<=%d" : ",%d", vectors[i]->scores.total);
+		}
+		printf("\n");
+	}
+}
+
+static void print_turn(const struct trace_record *records, int count, const struct trace_record *turn) {
+	if (heatmap) {
+		print_heatmap_turn(records, count);
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		const struct trace_record *record = &records[i];
+		if (record->type != TRACE_VECTOR) { continue; }
+
+		const struct trace_record *action = find_action(records, count, record->drone);
+		struct vec2d vector = movement_vectors[record->vector];
+
+		printf("%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%u,%016llx\n",
+				record->turn, record->drone, record->vector, vector.x, vector.y,
+				record->scores.fish, record->scores.scan, record->scores.drone, record->scores.explore, record->scores.search, record->scores.total,
+				(record->flags & TRACE_PRUNED) != 0, action && action->vector == record->vector, action ? action->light : 0,
+				turn->summary.plan_us, (unsigned long long)turn->summary.state_hash);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <trace file> [vectors|heatmap]\n", argv[0]);
+		return 1;
+	}
+	heatmap = (3 <= argc) && !strcmp(argv[2], "heatmap");
+
+	FILE *file = fopen(argv[1], "rb");
+	assert(file, "cannot open %s\n", argv[1]);
+
+	struct trace_header header;
+	assert(fread(&header, sizeof(header), 1, file) == 1, "truncated trace\n");
+	assert(header.magic == TRACE_MAGIC, "not a trace file\n");
+	assert(header.record_size == sizeof(struct trace_record), "trace record size %u, expected %zu\n", header.record_size, sizeof(struct trace_record));
+
+	compute_movement_vectors();
+	print_header();
+
+	struct trace_record records[TURN_RECORDS_MAX];
+	int count = 0;
+	struct trace_record record;
+
+	while (fread(&record, sizeof(record), 1, file) == 1) {
+		switch (record.type) {
+			case TRACE_VECTOR:
+			case TRACE_ACTION:
+				assert(count < ARRLEN(records), "too many records in turn %d\n", record.turn);
+				records[count] = record;
+				count += 1;
+				break;
+			case TRACE_TURN:
+				print_turn(records, count, &record);
+				count = 0;
+				break;
+			case TRACE_DROPPED:
+				if (record.dropped.count) {
+					fprintf(stderr, "%llu records were dropped\n", (unsigned long long)record.dropped.count);
+				}
+				break;
+		}
+	}
+
+	fclose(file);
+	return 0;
+}
@@ -0,0 +1,112 @@
+#include "tt.h"
+
+static uint64_t zobrist_x[TT_CELLS_X];
+static uint64_t zobrist_y[TT_CELLS_Y];
+static uint64_t zobrist_battery[DRONE_BATTERY_MAX + 1];
+static uint64_t zobrist_scans[FISH_COUNT];
+static uint64_t zobrist_ply[TT_PLY_MAX];
+static bool zobrist_ready;
+
+static uint64_t splitmix64(uint64_t *seed) {
+	uint64_t z = (*seed += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static void init_zobrist(void) {
+	uint64_t seed = 0x7a0b215742ULL;
+
+	for (int i = 0; i < ARRLEN(zobrist_x); i++) { zobrist_x[i] = splitmix64(&seed); }
+	for (int i = 0; i < ARRLEN(zobrist_y); i++) { zobrist_y[i] = splitmix64(&seed); }
+	for (int i = 0; i < ARRLEN(zobrist_battery); i++) { zobrist_battery[i] = splitmix64(&seed); }
+	for (int i = 0; i < ARRLEN(zobrist_scans); i++) { zobrist_scans[i] = splitmix64(&seed); }
+	for (int i = 0; i < ARRLEN(zobrist_ply); i++) { zobrist_ply[i] = splitmix64(&seed); }
+
+	zobrist_ready = true;
+}
+
+void tt_init(struct transposition_table *tt, int bucket_bits) {
+	if (!zobrist_ready) { init_zobrist(); }
+
+	size_t bucket_count = (size_t)1 << bucket_bits;
+	tt->buckets = aligned_alloc(sizeof(struct tt_bucket), bucket_count * sizeof(struct tt_bucket));
+	assert(tt->buckets, "cannot allocate %zu tt buckets\n", bucket_count);
+	memset(tt->buckets, 0, bucket_count * sizeof(struct tt_bucket));
+
+	tt->mask = bucket_count - 1;
+	tt->generation = 1;
+	memset(&tt->stats, 0, sizeof(tt->stats));
+}
+
+void tt_new_search(struct transposition_table *tt) {
+	tt->generation += 1;
+
+	/* NOTE(benjamin): Wrapping around would bring entries from 256 searches ago back to life. */
+	if (!tt->generation) {
+		memset(tt->buckets, 0, (tt->mask + 1) * sizeof(struct tt_bucket));
+		tt->generation = 1;
+	}
+}
+
+uint64_t tt_key(int x, int y, int battery, uint32_t scans, int ply) {
+	x = MAX(0, MIN(MAX_X, x)) / TT_CELL_SIZE;
+	y = MAX(0, MIN(MAX_Y, y)) / TT_CELL_SIZE;
+	battery = MAX(0, MIN(DRONE_BATTERY_MAX, battery));
+	ply = MIN(TT_PLY_MAX - 1, ply);
+
+	uint64_t key = zobrist_x[x] ^ zobrist_y[y] ^ zobrist_battery[battery] ^ zobrist_ply[ply];
+	for (int i = 0; i < FISH_COUNT; i++) {
+		if (scans & (1u << i)) { key ^= zobrist_scans[i]; }
+	}
+
+	return key;
+}
+
+const struct tt_entry *tt_probe(struct transposition_table *tt, uint64_t key, int depth) {
+	struct tt_bucket *bucket = &tt->buckets[key & tt->mask];
+	tt->stats.probes += 1;
+
+	for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+		struct tt_entry *entry = &bucket->entries[i];
+
+		if (entry->used && entry->key == key && entry->generation == tt->generation && depth <= entry->depth) {
+			tt->stats.hits += 1;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+void tt_store(struct transposition_table *tt, uint64_t key, int depth, int value, int best_move) {
+	struct tt_bucket *bucket = &tt->buckets[key & tt->mask];
+	struct tt_entry *victim = NULL;
+
+	for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+		struct tt_entry *entry = &bucket->entries[i];
+
+		if (!entry->used || entry->key == key) {
+			victim = entry;
+			break;
+		}
+
+		/* NOTE(benjamin): Stale generations go first, then the shallowest entry. */
+		if (!victim ||
+				(entry->generation != tt->generation && victim->generation == tt->generation) ||
+				((entry->generation == tt->generation) == (victim->generation == tt->generation) && entry->depth < victim->depth)) {
+			victim = entry;
+		}
+	}
+
+	if (victim->used && victim->key == key && victim->generation == tt->generation && depth < victim->depth) { return; }
+	if (victim->used && victim->key != key) { tt->stats.replacements += 1; }
+
+	victim->key = key;
+	victim->value = value;
+	victim->depth = depth;
+	victim->best_move = best_move;
+	victim->generation = tt->generation;
+	victim->used = 1;
+	tt->stats.stores += 1;
+}
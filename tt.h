@@ -0,0 +1,60 @@
+/*
+ * Transposition table for the multi-turn searches.
+ *
+ * Keys are Zobrist hashes of the quantized search state: drone position on a
+ * TT_CELL_SIZE grid, battery, scan mask and ply. Buckets are one cache line
+ * of four entries; a store replaces the shallowest entry of its bucket,
+ * preferring stale generations, so deep results survive the longest.
+ */
+#ifndef TT_H
+#define TT_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+#define TT_CELL_SIZE (100)
+#define TT_CELLS_X ((MAX_X / TT_CELL_SIZE) + 1)
+#define TT_CELLS_Y ((MAX_Y / TT_CELL_SIZE) + 1)
+#define TT_PLY_MAX (16)
+#define TT_BUCKET_ENTRIES (4)
+
+struct tt_entry {
+	uint64_t key;
+	int32_t value;
+	uint8_t depth;      /* remaining search depth the value was computed with */
+	uint8_t best_move;
+	uint8_t generation;
+	uint8_t used;
+};
+
+struct tt_bucket {
+	struct tt_entry entries[TT_BUCKET_ENTRIES];
+} __attribute__((aligned(64)));
+
+struct tt_stats {
+	long probes;
+	long hits;
+	long stores;
+	long replacements;
+};
+
+struct transposition_table {
+	struct tt_bucket *buckets;
+	uint64_t mask;
+	uint8_t generation;
+	struct tt_stats stats;
+};
+
+/* Allocates 2^bucket_bits buckets, only called at startup. */
+void tt_init(struct transposition_table *tt, int bucket_bits);
+/* Starts a new search generation, older entries are ignored and replaced first. */
+void tt_new_search(struct transposition_table *tt);
+
+uint64_t tt_key(int x, int y, int battery, uint32_t scans, int ply);
+
+/* Entry for key searched at least to depth, NULL otherwise. */
+const struct tt_entry *tt_probe(struct transposition_table *tt, uint64_t key, int depth);
+void tt_store(struct transposition_table *tt, uint64_t key, int depth, int value, int best_move);
+
+#endif
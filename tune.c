@@ -0,0 +1,241 @@
+/*
+ * SPSA tuner for the mark4 parameters.
+ *
+ *     cc -O2 -o tune tune.c match.c referee.c engine.c strategies.c movement.c symmetry.c radar.c danger.c intmath.c surfacing.c endgame.c foe.c lure.c rhea.c eval.c record.c pool.c trace.c fishsim.c tt.c search.c mark*.c node-chaser_mk1.c -lm -pthread
+ *     ./tune [iterations] [games per side] [workers] [seed]
+ *
+ * Every iteration perturbs all the parameters at once in a random direction
+ * and plays theta+ against theta- in-process. The score difference is the
+ * gradient estimate along that direction (Spall's SPSA). Matches are split
+ * across forked workers so the engine globals never need to be shared.
+ *
+ * The best parameters are written back to mark4_params.h after each
+ * iteration that beat the previous best against the starting parameters.
+ * Every iteration checks against the start on games of its own, so the best
+ * pick is selection biased; it is confirmed at the end on a seed range no
+ * iteration played, and the start is written back when it does not hold.
+ */
+#include <math.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mark4.h"
+#include "match.h"
+#include "referee.h"
+
+/* NOTE(benjamin): Far past any seed + (iteration << 20) the iterations use. */
+#define HOLDOUT_SEED_OFFSET (1ull << 40)
+#define HOLDOUT_GAMES_FACTOR (4)
+
+struct param_spec {
+	char *name;
+	size_t offset;
+	int min;
+	int max;
+	double step; /* perturbation size, in parameter units */
+};
+
+#define PARAM(name, min, max, step) { #name, offsetof(struct mark4_params, name), min, max, step }
+
+static const struct param_spec param_specs[] = {
+	PARAM(fish_value_scale, 10, 1000, 10),
+	PARAM(shared_fish_percent, 0, 100, 8),
+	PARAM(light_min_depth, 0, 5000, 300),
+	PARAM(light_cooldown, 1, 15, 1),
+	PARAM(color_blips_min, 0, FISH_TYPE_COUNT, 1),
+	PARAM(type_blips_min, 0, FISH_COLOR_COUNT, 1),
+	PARAM(fish_weight, 0, 400, 15),
+	PARAM(scan_weight, 0, 400, 15),
+	PARAM(drone_weight, 0, 400, 15),
+	PARAM(drone_repulsion, 0, 2000, 50),
+	PARAM(explore_weight, 0, 400, 15),
+	PARAM(search_depth, 0, 4, 1),
+	PARAM(search_weight, 0, 400, 15),
+};
+
+#define PARAM_COUNT ARRLEN(param_specs)
+
+static int *param_field(struct mark4_params *params, int i) {
+	return (int *)((char *)params + param_specs[i].offset);
+}
+
+static int param_value(const struct mark4_params *params, int i) {
+	return *(const int *)((const char *)params + param_specs[i].offset);
+}
+
+static struct mark4_params to_params(const double theta[PARAM_COUNT]) {
+	struct mark4_params params = mark4_params;
+
+	for (int i = 0; i < PARAM_COUNT; i++) {
+		int value = (int)lround(theta[i]);
+		*param_field(&params, i) = MAX(param_specs[i].min, MIN(param_specs[i].max, value));
+	}
+
+	return params;
+}
+
+/* NOTE(benjamin): Both contenders are mark4, they only differ by the params swapped in each turn. */
+static struct mark4_params contender_params[PLAYER_COUNT];
+
+static void contender_init(void) {
+	mark4_strategy.init();
+}
+
+static void contender_a_plan_turn(void) {
+	mark4_params = contender_params[0];
+	mark4_strategy.plan_turn();
+}
+
+static void contender_b_plan_turn(void) {
+	mark4_params = contender_params[1];
+	mark4_strategy.plan_turn();
+}
+
+static const struct strategy contender_a = { .name = "a", .init = contender_init, .plan_turn = contender_a_plan_turn };
+static const struct strategy contender_b = { .name = "b", .init = contender_init, .plan_turn = contender_b_plan_turn };
+
+/* Plays games a vs b with swapped sides, returns the summed score difference a - b. */
+static long play_games(const struct mark4_params *a, const struct mark4_params *b, int games, uint64_t seed) {
+	contender_params[0] = *a;
+	contender_params[1] = *b;
+
+	long diff = 0;
+	for (int i = 0; i < games; i++) {
+		int swap = i % 2;
+		const struct strategy *players[PLAYER_COUNT] = { swap ? &contender_b : &contender_a, swap ? &contender_a : &contender_b };
+		struct match_result result;
+
+		play_match(players, seed + (i / 2), &result);
+		diff += result.scores[swap] - result.scores[!swap];
+	}
+
+	return diff;
+}
+
+/* Same as play_games() split across forked workers, returns the mean score difference per game. */
+static double play_games_parallel(const struct mark4_params *a, const struct mark4_params *b, int games, int workers, uint64_t seed) {
+	int fds[workers];
+	pid_t pids[workers];
+	int games_per_worker = (games + workers - 1) / workers;
+	games_per_worker += games_per_worker % 2;
+
+	for (int w = 0; w < workers; w++) {
+		int pipe_fds[2];
+		assert(pipe(pipe_fds) == 0, "pipe failed\n");
+
+		pids[w] = fork();
+		assert(0 <= pids[w], "fork failed\n");
+
+		if (!pids[w]) {
+			close(pipe_fds[0]);
+			long diff = play_games(a, b, games_per_worker, seed + (uint64_t)w * games_per_worker);
+			assert(write(pipe_fds[1], &diff, sizeof(diff)) == sizeof(diff), "write failed\n");
+			_exit(0);
+		}
+
+		close(pipe_fds[1]);
+		fds[w] = pipe_fds[0];
+	}
+
+	long diff = 0;
+	for (int w = 0; w < workers; w++) {
+		long worker_diff = 0;
+		assert(read(fds[w], &worker_diff, sizeof(worker_diff)) == sizeof(worker_diff), "worker %d died\n", w);
+		close(fds[w]);
+		waitpid(pids[w], NULL, 0);
+		diff += worker_diff;
+	}
+
+	return (double)diff / (games_per_worker * workers);
+}
+
+static void write_params_header(const struct mark4_params *params) {
+	FILE *file = fopen("mark4_params.h", "w");
+	assert(file, "cannot write mark4_params.h\n");
+
+	fprintf(file, "/* Generated by tune, hand edits are overwritten on the next run. */\n");
+	fprintf(file, "#define MARK4_PARAMS { \\\n");
+	for (int i = 0; i < PARAM_COUNT; i++) {
+		fprintf(file, "\t.%s = %d, \\\n", param_specs[i].name, param_value(params, i));
+	}
+	fprintf(file, "}\n");
+
+	fclose(file);
+}
+
+int main(int argc, char **argv)
+{
+	int iterations = (2 <= argc) ? atoi(argv[1]) : 100;
+	int games = (3 <= argc) ? atoi(argv[2]) : 64;
+	int workers = (4 <= argc) ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	uint64_t seed = (5 <= argc) ? strtoull(argv[4], NULL, 0) : 1;
+	workers = MAX(1, workers);
+
+	/* NOTE(benjamin): Parallelism comes from the forked workers, keep the searches on their thread. */
+	mark4_search_threads = 1;
+
+	const struct mark4_params start = mark4_params;
+	struct mark4_params best = start;
+	double best_diff = 0;
+
+	double theta[PARAM_COUNT];
+	for (int i = 0; i < PARAM_COUNT; i++) {
+		theta[i] = param_value(&mark4_params, i);
+	}
+
+	uint64_t rng = seed;
+
+	for (int k = 0; k < iterations; k++) {
+		/* NOTE(benjamin): Usual SPSA gain sequences, a_k = a / (k + 1 + A)^0.602 and c_k = c / (k + 1)^0.101. */
+		double a_k = 0.05 / pow(k + 1 + (iterations / 10.0), 0.602);
+		double c_k = 1.0 / pow(k + 1, 0.101);
+
+		double delta[PARAM_COUNT];
+		double plus[PARAM_COUNT];
+		double minus[PARAM_COUNT];
+		for (int i = 0; i < PARAM_COUNT; i++) {
+			delta[i] = (rng_next(&rng) & 1) ? 1.0 : -1.0;
+			plus[i] = theta[i] + (c_k * param_specs[i].step * delta[i]);
+			minus[i] = theta[i] - (c_k * param_specs[i].step * delta[i]);
+		}
+
+		struct mark4_params params_plus = to_params(plus);
+		struct mark4_params params_minus = to_params(minus);
+		double gradient = play_games_parallel(&params_plus, &params_minus, games, workers, seed + ((uint64_t)k << 20));
+
+		for (int i = 0; i < PARAM_COUNT; i++) {
+			theta[i] += (a_k * param_specs[i].step * gradient) / (2.0 * c_k * delta[i]);
+			theta[i] = MAX(param_specs[i].min, MIN(param_specs[i].max, theta[i]));
+		}
+
+		struct mark4_params current = to_params(theta);
+		double vs_start = play_games_parallel(&current, &start, games, workers, seed + ((uint64_t)k << 20) + (1 << 19));
+
+		printf("iteration %d: plus-minus %+.2f/game, vs start %+.2f/game\n", k, gradient, vs_start);
+		fflush(stdout);
+
+		if (best_diff < vs_start) {
+			best = current;
+			best_diff = vs_start;
+			write_params_header(&best);
+		}
+	}
+
+	printf("best vs start: %+.2f/game (selection biased)\n", best_diff);
+	if (0 < best_diff) {
+		double holdout = play_games_parallel(&best, &start, HOLDOUT_GAMES_FACTOR * games, workers, seed + HOLDOUT_SEED_OFFSET);
+		printf("best vs start on held-out seeds: %+.2f/game\n", holdout);
+
+		if (holdout <= 0) {
+			printf("not confirmed, keeping the start\n");
+			best = start;
+			write_params_header(&best);
+		}
+	}
+	for (int i = 0; i < PARAM_COUNT; i++) {
+		printf("\t%s = %d\n", param_specs[i].name, param_value(&best, i));
+	}
+
+	return 0;
+}